@@ -0,0 +1,178 @@
+#include "MTCChannelMap.h"
+
+#include "TDirectory.h"
+#include "TTree.h"
+
+#include <algorithm>
+
+void MTCChannelMap::Clear()
+{
+    fChannels.clear();
+    fChannelPos.clear();
+    fChannelOffsets.clear();
+    fChannelFibres.clear();
+    fChannelWeights.clear();
+    fFibres.clear();
+    fFibrePos.clear();
+    fFibreOffsets.clear();
+    fFibreChannels.clear();
+    fFibreWeights.clear();
+}
+
+void MTCChannelMap::Build(std::vector<Overlap> overlaps)
+{
+    Clear();
+    std::stable_sort(overlaps.begin(), overlaps.end(), [](const Overlap& a, const Overlap& b) {
+        return a.channel < b.channel || (a.channel == b.channel && a.fibre < b.fibre);
+    });
+    // keep the last of equal (channel, fibre) pairs
+    std::vector<Overlap> unique;
+    unique.reserve(overlaps.size());
+    for (size_t i = 0; i < overlaps.size(); i++) {
+        if (i + 1 < overlaps.size() && overlaps[i + 1].channel == overlaps[i].channel
+            && overlaps[i + 1].fibre == overlaps[i].fibre) {
+            continue;
+        }
+        unique.push_back(overlaps[i]);
+    }
+
+    for (const auto& o : unique) {
+        fFibres.push_back(o.fibre);
+    }
+    std::sort(fFibres.begin(), fFibres.end());
+    fFibres.erase(std::unique(fFibres.begin(), fFibres.end()), fFibres.end());
+    fFibrePos.assign(fFibres.size(), 0);
+    std::vector<Int_t> count(fFibres.size(), 0);
+
+    // channel -> fibres, in ascending fibre number
+    fChannelOffsets.push_back(0);
+    Float_t m = 0;
+    Float_t w = 0;
+    for (size_t i = 0; i < unique.size(); i++) {
+        const Overlap& o = unique[i];
+        Int_t f = FindFibre(o.fibre);
+        fChannelFibres.push_back(f);
+        fChannelWeights.push_back(o.weight);
+        fFibrePos[f] = o.xpos;
+        count[f]++;
+        m += o.weight * o.xpos;
+        w += o.weight;
+        if (i + 1 == unique.size() || unique[i + 1].channel != o.channel) {
+            fChannels.push_back(o.channel);
+            fChannelPos.push_back(m / w);
+            fChannelOffsets.push_back(fChannelFibres.size());
+            m = 0;
+            w = 0;
+        }
+    }
+
+    // fibre -> channels, in ascending channel number
+    fFibreOffsets.assign(fFibres.size() + 1, 0);
+    for (size_t f = 0; f < fFibres.size(); f++) {
+        fFibreOffsets[f + 1] = fFibreOffsets[f] + count[f];
+    }
+    fFibreChannels.resize(fChannelFibres.size());
+    fFibreWeights.resize(fChannelFibres.size());
+    std::vector<Int_t> next(fFibreOffsets.begin(), fFibreOffsets.end() - 1);
+    for (size_t c = 0; c < fChannels.size(); c++) {
+        for (Int_t k = fChannelOffsets[c]; k < fChannelOffsets[c + 1]; k++) {
+            Int_t pos = next[fChannelFibres[k]]++;
+            fFibreChannels[pos] = c;
+            fFibreWeights[pos] = fChannelWeights[k];
+        }
+    }
+}
+
+Int_t MTCChannelMap::FindChannel(Int_t channel) const
+{
+    auto it = std::lower_bound(fChannels.begin(), fChannels.end(), channel);
+    return (it == fChannels.end() || *it != channel) ? -1 : it - fChannels.begin();
+}
+
+Int_t MTCChannelMap::FindFibre(Int_t fibre) const
+{
+    auto it = std::lower_bound(fFibres.begin(), fFibres.end(), fibre);
+    return (it == fFibres.end() || *it != fibre) ? -1 : it - fFibres.begin();
+}
+
+Float_t MTCChannelMap::GetChannelPosition(Int_t channel) const
+{
+    Int_t c = FindChannel(channel);
+    return c < 0 ? 0 : fChannelPos[c];
+}
+
+std::map<Int_t, std::map<Int_t, std::array<float, 2>>> MTCChannelMap::ChannelToFibres() const
+{
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> result;
+    for (size_t c = 0; c < fChannels.size(); c++) {
+        auto& row = result[fChannels[c]];
+        for (Int_t k = fChannelOffsets[c]; k < fChannelOffsets[c + 1]; k++) {
+            Int_t f = fChannelFibres[k];
+            row[fFibres[f]] = {fChannelWeights[k], fFibrePos[f]};
+        }
+    }
+    return result;
+}
+
+std::map<Int_t, std::map<Int_t, std::array<float, 2>>> MTCChannelMap::FibreToChannels() const
+{
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> result;
+    for (size_t f = 0; f < fFibres.size(); f++) {
+        auto& row = result[fFibres[f]];
+        for (Int_t k = fFibreOffsets[f]; k < fFibreOffsets[f + 1]; k++) {
+            row[fChannels[fFibreChannels[k]]] = {fFibreWeights[k], fFibrePos[f]};
+        }
+    }
+    return result;
+}
+
+std::map<Int_t, float> MTCChannelMap::ChannelPositions() const
+{
+    std::map<Int_t, float> result;
+    for (size_t c = 0; c < fChannels.size(); c++) {
+        result[fChannels[c]] = fChannelPos[c];
+    }
+    return result;
+}
+
+Bool_t MTCChannelMap::Read(TDirectory* dir, const char* name)
+{
+    auto* t = dir->Get<TTree>(name);
+    if (!t) {
+        return kFALSE;
+    }
+    Overlap o;
+    t->SetBranchAddress("channel", &o.channel);
+    t->SetBranchAddress("fibre", &o.fibre);
+    t->SetBranchAddress("weight", &o.weight);
+    t->SetBranchAddress("xpos", &o.xpos);
+    std::vector<Overlap> overlaps;
+    overlaps.reserve(t->GetEntries());
+    for (Long64_t n = 0; n < t->GetEntries(); n++) {
+        t->GetEntry(n);
+        overlaps.push_back(o);
+    }
+    t->ResetBranchAddresses();
+    Build(std::move(overlaps));
+    return !IsEmpty();
+}
+
+void MTCChannelMap::Write(const char* name) const
+{
+    Overlap o;
+    TTree t(name, "MTC fibre - SiPM channel overlaps");
+    t.Branch("channel", &o.channel);
+    t.Branch("fibre", &o.fibre);
+    t.Branch("weight", &o.weight);
+    t.Branch("xpos", &o.xpos);
+    for (size_t c = 0; c < fChannels.size(); c++) {
+        for (Int_t k = fChannelOffsets[c]; k < fChannelOffsets[c + 1]; k++) {
+            Int_t f = fChannelFibres[k];
+            o = {fChannels[c], fFibres[f], fChannelWeights[k], fFibrePos[f]};
+            t.Fill();
+        }
+    }
+    t.Write();
+    // detach from the output file, which would delete the tree again on Close
+    t.SetDirectory(nullptr);
+}
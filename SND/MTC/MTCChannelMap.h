@@ -0,0 +1,81 @@
+#ifndef SND_MTC_MTCCHANNELMAP_H_
+#define SND_MTC_MTCCHANNELMAP_H_ 1
+
+#include "Rtypes.h"
+
+#include <array>
+#include <map>
+#include <vector>
+
+class TDirectory;
+
+/**
+ ** Overlap of the fibres and the SiPM channels of one MTC fibre plane (U or V),
+ ** stored in compressed sparse row form in both directions:
+ **  - channel c (index into GetChannels()) sees the fibres GetChannelFibres()[k]
+ **    with weights GetChannelWeights()[k], k in [GetChannelOffsets()[c], GetChannelOffsets()[c+1])
+ **  - fibre f (index into GetFibres()) is seen by the channels GetFibreChannels()[k]
+ **    with weights GetFibreWeights()[k], k in [GetFibreOffsets()[f], GetFibreOffsets()[f+1])
+ ** Channel and fibre numbers are the local ones (global ID % 1000000), sorted ascending,
+ ** the weight is the fraction of the fibre cross section seen by the channel.
+ **/
+class MTCChannelMap
+{
+  public:
+    struct Overlap
+    {
+        Int_t channel;
+        Int_t fibre;
+        Float_t weight;
+        Float_t xpos;   ///< local x of the fibre
+    };
+
+    MTCChannelMap() = default;
+
+    /** Build the map from the list of overlaps, for duplicate pairs the last one is kept **/
+    void Build(std::vector<Overlap> overlaps);
+    void Clear();
+    Bool_t IsEmpty() const { return fChannels.empty(); }
+
+    Int_t GetNChannels() const { return fChannels.size(); }
+    Int_t GetNFibres() const { return fFibres.size(); }
+    /** index of the local channel / fibre number, -1 if not mapped **/
+    Int_t FindChannel(Int_t channel) const;
+    Int_t FindFibre(Int_t fibre) const;
+    /** weighted mean local x of the fibres seen by the channel, 0 if not mapped **/
+    Float_t GetChannelPosition(Int_t channel) const;
+
+    const std::vector<Int_t>& GetChannels() const { return fChannels; }
+    const std::vector<Float_t>& GetChannelPositions() const { return fChannelPos; }
+    const std::vector<Int_t>& GetChannelOffsets() const { return fChannelOffsets; }
+    const std::vector<Int_t>& GetChannelFibres() const { return fChannelFibres; }
+    const std::vector<Float_t>& GetChannelWeights() const { return fChannelWeights; }
+    const std::vector<Int_t>& GetFibres() const { return fFibres; }
+    const std::vector<Float_t>& GetFibrePositions() const { return fFibrePos; }
+    const std::vector<Int_t>& GetFibreOffsets() const { return fFibreOffsets; }
+    const std::vector<Int_t>& GetFibreChannels() const { return fFibreChannels; }
+    const std::vector<Float_t>& GetFibreWeights() const { return fFibreWeights; }
+
+    /** Nested maps {weight, fibre x}, as filled by the former SiPMmapping **/
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> ChannelToFibres() const;
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> FibreToChannels() const;
+    std::map<Int_t, float> ChannelPositions() const;
+
+    /** Read / write the overlaps as tree with the given name **/
+    Bool_t Read(TDirectory* dir, const char* name);
+    void Write(const char* name) const;
+
+  private:
+    std::vector<Int_t> fChannels;
+    std::vector<Float_t> fChannelPos;
+    std::vector<Int_t> fChannelOffsets;
+    std::vector<Int_t> fChannelFibres;
+    std::vector<Float_t> fChannelWeights;
+    std::vector<Int_t> fFibres;
+    std::vector<Float_t> fFibrePos;
+    std::vector<Int_t> fFibreOffsets;
+    std::vector<Int_t> fFibreChannels;
+    std::vector<Float_t> fFibreWeights;
+};
+
+#endif   // SND_MTC_MTCCHANNELMAP_H_
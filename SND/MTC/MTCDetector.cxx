@@ -35,11 +35,17 @@
 
 // Additional standard headers
 #include "TClonesArray.h"
+#include "TFile.h"
 #include "TList.h"       // for TListIter, TList (ptr only)
 #include "TObjArray.h"   // for TObjArray
+#include "TParameter.h"
 #include "TString.h"     // for TString
 #include "TVirtualMC.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
 using namespace ShipUnit;
 
 namespace
@@ -153,6 +159,7 @@ MTCDetector::MTCDetector()
     , fLength(-1.)
     , fELoss(-1)
     , fMTCDetectorPointCollection(new TClonesArray("MtcDetPoint"))
+    , fTransformGeo(nullptr)
 {}
 
 MTCDetector::MTCDetector(const char* name, Bool_t Active, const char* Title, Int_t DetId)
@@ -165,6 +172,7 @@ MTCDetector::MTCDetector(const char* name, Bool_t Active, const char* Title, Int
     , fLength(-1.)
     , fELoss(-1)
     , fMTCDetectorPointCollection(new TClonesArray("MtcDetPoint"))
+    , fTransformGeo(nullptr)
 {}
 
 MTCDetector::~MTCDetector()
@@ -576,49 +584,35 @@ void MTCDetector::GetPosition(Int_t fDetectorID, TVector3& A, TVector3& B)
         - 123: number of the SiPM channel (0-127, 128 channels per SiPM)
     */
 
-    Int_t station_number = int(fDetectorID / 1e6) % 100;
+    const MTCPlaneTransform* t = GetPlaneTransform(fDetectorID);
     Int_t plane_type = int(fDetectorID / 1e5) % 10;   // 0 for horizontal, 1 for vertical
-    Int_t mat_number = int(fDetectorID / 1e4) % 10;
-
-    TString sID, stationID;
-    sID.Form("%i", fDetectorID);
-    stationID.Form("%i", station_number);
-    // Basic hierarchy: /cave/MTC_1/MTC_layer_1/MTC_sciFi_mother_1/MTC_sciFi_epoxyMat_U_1/FiberVol_101010187
-    TString path = "/cave/MTC_1/MTC_layer_" + stationID
-                   + ((plane_type == 0) ? "/MTC_scifi_U_0/MTC_epoxyMat_0/FiberVol_1010"
-                                        : "/MTC_scifi_V_0/MTC_epoxyMat_0/FiberVol_1011");
-    path += sID(4, 5);
-    TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
-    nav->cd(path);
-    TGeoNode* W = nav->GetCurrentNode();
-    TGeoBBox* S = dynamic_cast<TGeoBBox*>(W->GetVolume()->GetShape());
-
-    Double_t top[3] = {0, 0, (S->GetDZ())};
-    Double_t bot[3] = {0, 0, -(S->GetDZ())};
+    if (!t) {
+        LOG(WARN) << "MTCDetector::GetPosition, no fibre plane for detID " << fDetectorID;
+        return;
+    }
+    auto it = fFibreEnds[plane_type].find(fDetectorID % 100000);
+    if (it == fFibreEnds[plane_type].end()) {
+        LOG(WARN) << "MTCDetector::GetPosition, no fibre with detID " << fDetectorID;
+        return;
+    }
     Double_t Gtop[3], Gbot[3];
-    nav->LocalToMaster(top, Gtop);
-    nav->LocalToMaster(bot, Gbot);
+    t->mat.LocalToMaster(it->second.data(), Gtop);
+    t->mat.LocalToMaster(it->second.data() + 3, Gbot);
     A.SetXYZ(Gtop[0], Gtop[1], Gtop[2]);
     B.SetXYZ(Gbot[0], Gbot[1], Gbot[2]);
 }
 
 TVector3 MTCDetector::GetLocalPos(Int_t fDetectorID, TVector3* glob)
 {
-    Int_t station_number = int(fDetectorID / 1e6) % 100;
-    Int_t plane_type = int(fDetectorID / 1e5) % 10;   // 0 for horizontal, 1 for vertical
-    Int_t mat_number = int(fDetectorID / 1e4) % 10;
-
-    TString sID, stationID;
-    sID.Form("%i", fDetectorID);
-    stationID.Form("%i", station_number);
-    // Basic hierarchy: /cave/MTC_1/MTC_layer_1/MTC_sciFi_mother_1/MTC_sciFi_epoxyMat_U_1/FiberVol_101010187
-    TString path = "/cave/MTC_1/MTC_layer_" + stationID + ((plane_type == 0) ? "/MTC_scifi_U_0" : "/MTC_scifi_V_0");
-    TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
-    nav->cd(path);
+    const MTCPlaneTransform* t = GetPlaneTransform(fDetectorID);
+    if (!t) {
+        LOG(WARN) << "MTCDetector::GetLocalPos, no fibre plane for detID " << fDetectorID;
+        return TVector3();
+    }
     Double_t aglob[3];
     Double_t aloc[3];
     glob->GetXYZ(aglob);
-    nav->MasterToLocal(aglob, aloc);
+    t->plane.MasterToLocal(aglob, aloc);
     return TVector3(aloc[0], aloc[1], aloc[2]);
 }
 
@@ -640,134 +634,268 @@ void MTCDetector::GetSiPMPosition(Int_t SiPMChan, TVector3& A, TVector3& B)
           - 123: number of the SiPM channel (0-127, 128 channels per SiPM)
     */
     Int_t locNumber = SiPMChan % 1000000;
-    Int_t station_number = int(SiPMChan / 1e6) % 100;
-    Int_t plane_type = int(SiPMChan / 1e5) % 10;   // 0 for horizontal, 1 for vertical
+    const MTCPlaneTransform* t = GetPlaneTransform(SiPMChan);
+    if (!t) {
+        LOG(WARN) << "MTCDetector::GetSiPMPosition, no fibre plane for channel " << SiPMChan;
+        return;
+    }
     Float_t locPosition;
-    locPosition = (plane_type == 0 ? SiPMPos_U : SiPMPos_V)[locNumber];   // local position in U/V plane
-    TString stationID;
-    stationID.Form("%i", station_number);
+    locPosition = GetChannelMap(SiPMChan).GetChannelPosition(locNumber);   // local position in U/V plane
 
     Double_t loc[3] = {0, 0, 0};
-    TString path = "/cave/MTC_1/MTC_layer_" + stationID
-                   + ((plane_type == 0) ? "/MTC_scifi_U_0/MTC_epoxyMat_0" : "/MTC_scifi_V_0/MTC_epoxyMat_0");
-    TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
     Double_t glob[3] = {0, 0, 0};
     loc[0] = locPosition;
     loc[1] = -fFiberLength / 2;
     loc[2] = 7.47;
-    nav->cd(path);
-    nav->LocalToMaster(loc, glob);
+    t->mat.LocalToMaster(loc, glob);
     A.SetXYZ(glob[0], glob[1], glob[2]);
     loc[0] = locPosition;
     loc[1] = fFiberLength / 2;
     loc[2] = 7.47;   // hardcoded for now, for some reason required to get the correct local position
-    nav->LocalToMaster(loc, glob);
+    t->mat.LocalToMaster(loc, glob);
     B.SetXYZ(glob[0], glob[1], glob[2]);
 }
 
+void MTCDetector::BuildTransformCache()
+{
+    fPlaneTransforms.clear();
+    fFibreEnds[0].clear();
+    fFibreEnds[1].clear();
+    fTransformGeo = gGeoManager;
+    auto mtc = gGeoManager ? gGeoManager->FindVolumeFast("MTC") : nullptr;
+    if (!mtc || !mtc->GetNodes()) {
+        LOG(WARN) << "MTCDetector: no MTC in the geometry, no transforms cached";
+        return;
+    }
+    // Basic hierarchy: /cave/MTC_1/MTC_layer_1/MTC_scifi_U_0/MTC_epoxyMat_0/FiberVol_101010187
+    TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
+    nav->PushPath();
+    for (Int_t i = 0; i < mtc->GetNodes()->GetEntriesFast(); i++) {
+        auto layer = static_cast<TGeoNode*>(mtc->GetNodes()->At(i));
+        if (strcmp(layer->GetVolume()->GetName(), "MTC_layer") != 0) {
+            continue;
+        }
+        for (Int_t plane_type : {0, 1}) {
+            TString path =
+                Form("/cave/MTC_1/MTC_layer_%i/MTC_scifi_%s_0", layer->GetNumber(), plane_type == 0 ? "U" : "V");
+            if (!nav->cd(path)) {
+                continue;
+            }
+            MTCPlaneTransform& t = fPlaneTransforms[10 * layer->GetNumber() + plane_type];
+            t.plane = *nav->GetCurrentMatrix();
+            if (!nav->cd(path + "/MTC_epoxyMat_0")) {
+                fPlaneTransforms.erase(10 * layer->GetNumber() + plane_type);
+                continue;
+            }
+            t.mat = *nav->GetCurrentMatrix();
+            TGeoVolume* vmat = nav->GetCurrentVolume();
+            auto box = dynamic_cast<TGeoBBox*>(vmat->GetShape());
+            t.matHalf[0] = box->GetDX();
+            t.matHalf[1] = box->GetDY();
+            t.matHalf[2] = box->GetDZ();
+            // fibre end points in the mat, the same in all layers
+            if (!fFibreEnds[plane_type].empty() || !vmat->GetNodes()) {
+                continue;
+            }
+            for (Int_t ifibre = 0; ifibre < vmat->GetNodes()->GetEntriesFast(); ifibre++) {
+                auto fibre = static_cast<TGeoNode*>(vmat->GetNodes()->At(ifibre));
+                auto S = dynamic_cast<TGeoBBox*>(fibre->GetVolume()->GetShape());
+                Double_t top[3] = {0, 0, (S->GetDZ())};
+                Double_t bot[3] = {0, 0, -(S->GetDZ())};
+                std::array<Double_t, 6>& ends = fFibreEnds[plane_type][fibre->GetNumber() % 100000];
+                fibre->GetMatrix()->LocalToMaster(top, ends.data());
+                fibre->GetMatrix()->LocalToMaster(bot, ends.data() + 3);
+            }
+        }
+    }
+    nav->PopPath();
+}
+
+const MTCPlaneTransform* MTCDetector::GetPlaneTransform(Int_t detID)
+{
+    // scanned once per geometry, also when it has no MTC planes
+    if (fTransformGeo != gGeoManager) {
+        BuildTransformCache();
+    }
+    Int_t station_number = int(detID / 1e6) % 100;
+    Int_t plane_type = int(detID / 1e5) % 10;   // 0 for horizontal, 1 for vertical
+    if (plane_type > 1) {
+        return nullptr;
+    }
+    auto it = fPlaneTransforms.find(10 * station_number + plane_type);
+    return it == fPlaneTransforms.end() ? nullptr : &it->second;
+}
+
 void MTCDetector::SiPMmapping()
 {
     // check if containers are already filled
-    if (!fibresSiPM_U.empty() || !fibresSiPM_V.empty() || !SiPMPos_U.empty() || !SiPMPos_V.empty()) {
+    if (!fChannelMapU.IsEmpty() || !fChannelMapV.IsEmpty()) {
         LOG(WARN) << "SiPM mapping already done, skipping.";
         return;
     }
-    Float_t fibresRadius = -1;
-    Float_t dSiPM = -1;
-    TGeoNode* vol;
-    TGeoNode* fibre;
+    // SiPM channels first, the cache is checked against them
     SiPMOverlap();
-    // Loop over both U and V planes
-    std::vector<std::pair<const char*, const char*>> sipm_planes = {{"SiPMmapVolU", "MTC_scifi_U"},
-                                                                    {"SiPMmapVolV", "MTC_scifi_V"}};
-    for (const auto& [sipm_vol, scifi_vol] : sipm_planes) {
-        auto sipm = gGeoManager->FindVolumeFast(sipm_vol);
-        if (!sipm)
-            continue;
-        TObjArray* Nodes = sipm->GetNodes();
-        auto plane = gGeoManager->FindVolumeFast(scifi_vol);
-        if (!plane)
-            continue;
-        for (int imat = 0; imat < plane->GetNodes()->GetEntries(); imat++) {
-            auto mat = static_cast<TGeoNode*>(plane->GetNodes()->At(imat));
-            Float_t t1 = mat->GetMatrix()->GetTranslation()[0];
-            auto vmat = mat->GetVolume();
-            for (int ifibre = 0; ifibre < vmat->GetNodes()->GetEntriesFast(); ifibre++) {
-                fibre = static_cast<TGeoNode*>(vmat->GetNodes()->At(ifibre));
-                if (fibresRadius < 0) {
-                    auto tmp = fibre->GetVolume()->GetShape();
-                    auto S = dynamic_cast<TGeoBBox*>(tmp);
-                    fibresRadius = S->GetDX();
-                }
-                Int_t fID =
-                    fibre->GetNumber() % 1000000 + imat * 1e4;   // local fibre number, global fibre number = SO+fID
-                TVector3 Atop, Bbot;
-                GetPosition(fibre->GetNumber(), Atop, Bbot);
-                Float_t a = Atop[0];
-
-                //  check for overlap with any of the SiPM channels in the same mat
-                for (Int_t nChan = 0; nChan < Nodes->GetEntriesFast(); nChan++) {   // 7 SiPMs total times 128 channels
-                    vol = static_cast<TGeoNode*>(Nodes->At(nChan));
-                    Int_t N = vol->GetNumber();
-                    Float_t xcentre = vol->GetMatrix()->GetTranslation()[0];
-                    if (dSiPM < 0) {
-                        TGeoBBox* B = dynamic_cast<TGeoBBox*>(vol->GetVolume()->GetShape());
-                        dSiPM = B->GetDX();
-                    }
-                    if (TMath::Abs(xcentre - a) > 4 * fibresRadius) {
-                        continue;
-                    }   // no need to check further
-                    Float_t W = area(a, fibresRadius, xcentre - dSiPM, xcentre + dSiPM);
-                    if (W < 0) {
-                        continue;
-                    }
-                    std::array<float, 2> Wa;
-                    Wa[0] = W;
-                    Wa[1] = a;
-                    if (sipm_vol == std::string("SiPMmapVolU")) {
-                        fibresSiPM_U[N][fID] = Wa;
-                    } else {
-                        fibresSiPM_V[N][fID] = Wa;
-                    }
-                }
-            }
+    if (fChannelMapCache.Length() > 0 && ReadChannelMapCache()) {
+        return;
+    }
+    MapPlane("SiPMmapVolU", "MTC_scifi_U", fChannelMapU);
+    MapPlane("SiPMmapVolV", "MTC_scifi_V", fChannelMapV);
+    if (fChannelMapCache.Length() > 0) {
+        WriteChannelMapCache();
+    }
+}
+
+void MTCDetector::MapPlane(const char* sipmVolume, const char* scifiVolume, MTCChannelMap& map)
+{
+    auto sipm = gGeoManager->FindVolumeFast(sipmVolume);
+    auto plane = gGeoManager->FindVolumeFast(scifiVolume);
+    if (!sipm || !plane) {
+        return;
+    }
+    // SiPM channels sorted by their centre
+    TObjArray* Nodes = sipm->GetNodes();
+    std::vector<std::pair<Float_t, Int_t>> channels;
+    channels.reserve(Nodes->GetEntriesFast());
+    Float_t dSiPM = -1;
+    for (Int_t nChan = 0; nChan < Nodes->GetEntriesFast(); nChan++) {   // 7 SiPMs total times 128 channels
+        auto vol = static_cast<TGeoNode*>(Nodes->At(nChan));
+        if (dSiPM < 0) {
+            TGeoBBox* B = dynamic_cast<TGeoBBox*>(vol->GetVolume()->GetShape());
+            dSiPM = B->GetDX();
         }
-        // calculate also local SiPM positions based on fibre positions and their fraction
-        // probably an overkill, maximum difference between weighted average and central position < 6 micron.
-        if (sipm_vol == std::string("SiPMmapVolU")) {
-            for (auto [N, it] : fibresSiPM_U) {
-                Float_t m = 0;
-                Float_t w = 0;
-                for (auto [fibre, Wa] : it) {
-                    m += Wa[0] * Wa[1];
-                    w += Wa[0];
-                }
-                SiPMPos_U[N] = m / w;
+        channels.emplace_back(vol->GetMatrix()->GetTranslation()[0], vol->GetNumber());
+    }
+    std::stable_sort(
+        channels.begin(), channels.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+
+    std::vector<MTCChannelMap::Overlap> overlaps;
+    Float_t fibresRadius = -1;
+    for (int imat = 0; imat < plane->GetNodes()->GetEntries(); imat++) {
+        auto mat = static_cast<TGeoNode*>(plane->GetNodes()->At(imat));
+        auto vmat = mat->GetVolume();
+        // fibres of the mat sorted by their position
+        std::vector<std::pair<Float_t, Int_t>> fibres;
+        fibres.reserve(vmat->GetNodes()->GetEntriesFast());
+        for (int ifibre = 0; ifibre < vmat->GetNodes()->GetEntriesFast(); ifibre++) {
+            auto fibre = static_cast<TGeoNode*>(vmat->GetNodes()->At(ifibre));
+            if (fibresRadius < 0) {
+                auto tmp = fibre->GetVolume()->GetShape();
+                auto S = dynamic_cast<TGeoBBox*>(tmp);
+                fibresRadius = S->GetDX();
             }
-            // make inverse mapping, which fibre is associated to which SiPMs
-            for (auto [N, it] : fibresSiPM_U) {
-                for (auto [nfibre, Wa] : it) {
-                    siPMFibres_U[nfibre][N] = Wa;
-                }
+            TVector3 Atop, Bbot;
+            GetPosition(fibre->GetNumber(), Atop, Bbot);
+            Float_t a = Atop[0];
+            Int_t fID = fibre->GetNumber() % 1000000 + imat * 1e4;   // local fibre number, global fibre number = SO+fID
+            fibres.emplace_back(a, fID);
+        }
+        std::stable_sort(fibres.begin(), fibres.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+
+        // sweep: the window of channels within 4 fibre radii only moves forward
+        size_t first = 0;
+        for (const auto& [a, fID] : fibres) {
+            while (first < channels.size() && channels[first].first - a < -4 * fibresRadius) {
+                first++;
             }
-        } else if (sipm_vol == std::string("SiPMmapVolV")) {
-            for (auto [N, it] : fibresSiPM_V) {
-                Float_t m = 0;
-                Float_t w = 0;
-                for (auto [fibre, Wa] : it) {
-                    m += Wa[0] * Wa[1];
-                    w += Wa[0];
+            for (size_t j = first; j < channels.size() && channels[j].first - a <= 4 * fibresRadius; j++) {
+                Float_t xcentre = channels[j].first;
+                Float_t W = area(a, fibresRadius, xcentre - dSiPM, xcentre + dSiPM);
+                if (W < 0) {
+                    continue;
                 }
-                SiPMPos_V[N] = m / w;
+                overlaps.push_back({channels[j].second, fID, W, a});
             }
-            // make inverse mapping, which fibre is associated to which SiPMs
-            for (auto [N, it] : fibresSiPM_V) {
-                for (auto [nfibre, Wa] : it) {
-                    siPMFibres_V[nfibre][N] = Wa;
-                }
+        }
+    }
+    // also calculates the local SiPM positions as weighted mean of the fibre positions,
+    // probably an overkill, maximum difference between weighted average and central position < 6 micron.
+    map.Build(std::move(overlaps));
+}
+
+std::vector<std::pair<TString, Double_t>> MTCDetector::ChannelMapParameters() const
+{
+    std::vector<std::pair<TString, Double_t>> pars = {{"width", fWidth},
+                                                      {"height", fHeight},
+                                                      {"angle", fSciFiBendingAngle},
+                                                      {"activeX", fSciFiActiveX},
+                                                      {"activeY", fSciFiActiveY},
+                                                      {"matThick", fiberMatThick},
+                                                      {"fibrePitch", fFiberPitch},
+                                                      {"fibreLength", fFiberLength}};
+    // SiPM channels and fibres as placed in the geometry
+    for (const char* p : {"U", "V"}) {
+        TString plane(p);
+        auto sipm = gGeoManager ? gGeoManager->FindVolumeFast("SiPMmapVol" + plane) : nullptr;
+        Int_t nChannels = sipm && sipm->GetNodes() ? sipm->GetNodes()->GetEntriesFast() : 0;
+        pars.emplace_back("channels" + plane, nChannels);
+        if (nChannels > 0) {
+            auto first = static_cast<TGeoNode*>(sipm->GetNodes()->At(0));
+            auto last = static_cast<TGeoNode*>(sipm->GetNodes()->At(nChannels - 1));
+            pars.emplace_back("channelHalfWidth" + plane, dynamic_cast<TGeoBBox*>(first->GetVolume()->GetShape())->GetDX());
+            pars.emplace_back("firstChannelX" + plane, first->GetMatrix()->GetTranslation()[0]);
+            pars.emplace_back("lastChannelX" + plane, last->GetMatrix()->GetTranslation()[0]);
+        }
+        auto scifi = gGeoManager ? gGeoManager->FindVolumeFast("MTC_scifi_" + plane) : nullptr;
+        Int_t nMats = scifi && scifi->GetNodes() ? scifi->GetNodes()->GetEntriesFast() : 0;
+        pars.emplace_back("mats" + plane, nMats);
+        for (Int_t imat = 0; imat < nMats; imat++) {
+            auto vmat = static_cast<TGeoNode*>(scifi->GetNodes()->At(imat))->GetVolume();
+            TString mat = plane;
+            mat += imat;
+            Int_t nFibres = vmat->GetNodes() ? vmat->GetNodes()->GetEntriesFast() : 0;
+            pars.emplace_back("fibres" + mat, nFibres);
+            if (nFibres == 0) {
+                continue;
             }
+            auto first = static_cast<TGeoNode*>(vmat->GetNodes()->At(0));
+            auto last = static_cast<TGeoNode*>(vmat->GetNodes()->At(nFibres - 1));
+            pars.emplace_back("fibreRadius" + mat, dynamic_cast<TGeoBBox*>(first->GetVolume()->GetShape())->GetDX());
+            pars.emplace_back("firstFibreX" + mat, first->GetMatrix()->GetTranslation()[0]);
+            pars.emplace_back("lastFibreX" + mat, last->GetMatrix()->GetTranslation()[0]);
         }
     }
+    return pars;
+}
+
+Bool_t MTCDetector::ReadChannelMapCache()
+{
+    std::unique_ptr<TFile> f(TFile::Open(fChannelMapCache, "READ"));
+    if (!f || f->IsZombie()) {
+        return kFALSE;
+    }
+    for (const auto& [name, value] : ChannelMapParameters()) {
+        auto* cached = f->Get<TParameter<Double_t>>(name);
+        if (!cached || cached->GetVal() != value) {
+            LOG(INFO) << "SiPM mapping cache " << fChannelMapCache << " does not match the geometry (" << name
+                      << "), rebuilding";
+            return kFALSE;
+        }
+    }
+    if (!fChannelMapU.Read(f.get(), "channelMapU") || !fChannelMapV.Read(f.get(), "channelMapV")) {
+        fChannelMapU.Clear();
+        fChannelMapV.Clear();
+        return kFALSE;
+    }
+    LOG(INFO) << "SiPM mapping read from " << fChannelMapCache;
+    return kTRUE;
+}
+
+void MTCDetector::WriteChannelMapCache() const
+{
+    TDirectory* dir = gDirectory;
+    std::unique_ptr<TFile> f(TFile::Open(fChannelMapCache, "RECREATE"));
+    if (!f || f->IsZombie()) {
+        LOG(WARN) << "Cannot write SiPM mapping cache " << fChannelMapCache;
+        dir->cd();
+        return;
+    }
+    fChannelMapU.Write("channelMapU");
+    fChannelMapV.Write("channelMapV");
+    for (const auto& [name, value] : ChannelMapParameters()) {
+        TParameter<Double_t>(name, value).Write();
+    }
+    f->Close();
+    dir->cd();
 }
 
 void MTCDetector::Register()
@@ -3,14 +3,20 @@
 
 #include "FairDetector.h"
 #include "FairModule.h"   // for FairModule
+#include "MTCChannelMap.h"
 #include "MtcDetPoint.h"
 #include "Rtypes.h"   // for ShipMuonShield::Class, Bool_t, etc
 #include "TClonesArray.h"
 #include "TGeoMatrix.h"
 #include "TLorentzVector.h"
+#include "TString.h"
 #include "TVector3.h"
 
+#include <array>
 #include <string>   // for string
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class MtcDetPoint;
 class TGeoVolume;
@@ -18,6 +24,15 @@ class TGeoVolumeAssembly;
 class TGeoMedium;
 class FairVolume;
 class TClonesArray;
+class TGeoManager;
+
+/** Global transforms of one fibre plane (U or V) of one MTC layer **/
+struct MTCPlaneTransform
+{
+    TGeoHMatrix plane;      ///< MTC_scifi_U/V to global
+    TGeoHMatrix mat;        ///< epoxy mat holding the fibres to global
+    Double_t matHalf[3];    ///< half sizes of the epoxy mat
+};
 
 class MTCDetector : public FairDetector
 {
@@ -61,13 +76,42 @@ class MTCDetector : public FairDetector
     TVector3 GetLocalPos(Int_t fDetectorID, TVector3* glob);
     /** mean position of fibre2 associated with SiPM channel **/
     void GetSiPMPosition(Int_t SiPMChan, TVector3& A, TVector3& B);
+    /** Transforms of all fibre planes and fibre end points in the mats, taken once per geometry.
+     *  The position queries above use them instead of navigating, built on first use if needed.
+     **/
+    void BuildTransformCache();
+    /** transforms of the plane of a fibre or SiPM channel ID, nullptr if not in the geometry **/
+    const MTCPlaneTransform* GetPlaneTransform(Int_t detID);
+    /** Fibre <-> SiPM channel overlaps of the U and V planes, read from the cache file if set **/
     void SiPMmapping();
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetSiPMmapU() { return fibresSiPM_U; }
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetFibresMapU() { return siPMFibres_U; }
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetSiPMmapV() { return fibresSiPM_V; }
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetFibresMapV() { return siPMFibres_V; }
-    std::map<Int_t, float> GetSiPMPos_U() { return SiPMPos_U; }
-    std::map<Int_t, float> GetSiPMPos_V() { return SiPMPos_V; }
+    /** optional file the SiPM mapping is read from, or written to if missing or outdated **/
+    void SetChannelMapCache(const char* fileName) { fChannelMapCache = fileName; }
+    const MTCChannelMap& GetChannelMapU() const { return fChannelMapU; }
+    const MTCChannelMap& GetChannelMapV() const { return fChannelMapV; }
+    /** channel map of the plane type of the local or global fibre / channel ID **/
+    const MTCChannelMap& GetChannelMap(Int_t detID) const
+    {
+        return int(detID / 100000) % 10 == 0 ? fChannelMapU : fChannelMapV;
+    }
+    /** nested map copies of the channel maps, kept for the python mapping tools **/
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetSiPMmapU() const
+    {
+        return fChannelMapU.ChannelToFibres();
+    }
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetFibresMapU() const
+    {
+        return fChannelMapU.FibreToChannels();
+    }
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetSiPMmapV() const
+    {
+        return fChannelMapV.ChannelToFibres();
+    }
+    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> GetFibresMapV() const
+    {
+        return fChannelMapV.FibreToChannels();
+    }
+    std::map<Int_t, float> GetSiPMPos_U() const { return fChannelMapU.ChannelPositions(); }
+    std::map<Int_t, float> GetSiPMPos_V() const { return fChannelMapV.ChannelPositions(); }
     Float_t Get_SciFiActiveX() const { return fSciFiActiveX; }
     virtual void SiPMOverlap();
     virtual Bool_t ProcessHits(FairVolume* vol = 0);
@@ -112,17 +156,24 @@ class MTCDetector : public FairDetector
     Double_t fiberMatThick;
     Double_t fFiberLength;
     Double_t fFiberPitch;
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> fibresSiPM_U;   //! mapping of fibres to SiPM channels
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> siPMFibres_U;   //! inverse mapping
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> fibresSiPM_V;   //! mapping of fibres to SiPM channels
-    std::map<Int_t, std::map<Int_t, std::array<float, 2>>> siPMFibres_V;   //! inverse mapping
-    std::map<Int_t, float> SiPMPos_U, SiPMPos_V;                           //! local SiPM channel position
+    MTCChannelMap fChannelMapU;   //! fibre <-> SiPM channel overlaps, U plane
+    MTCChannelMap fChannelMapV;   //! fibre <-> SiPM channel overlaps, V plane
+    TString fChannelMapCache;     //! optional cache file of the channel maps
+    std::unordered_map<Int_t, MTCPlaneTransform> fPlaneTransforms;       //! 10 * layer + plane type -> transforms
+    std::unordered_map<Int_t, std::array<Double_t, 6>> fFibreEnds[2];   //! fibre ID % 100000 -> top, bottom in the mat
+    TGeoManager* fTransformGeo;                                          //! geometry the transforms were taken from
     /** container for data points */
     TClonesArray* fMTCDetectorPointCollection;
 
     MTCDetector(const MTCDetector&);
     MTCDetector& operator=(const MTCDetector&);
     Int_t InitMedium(const char* name);
+    /** overlaps of the fibres of one plane with its SiPM channels, sweeping both sorted by x **/
+    void MapPlane(const char* sipmVolume, const char* scifiVolume, MTCChannelMap& map);
+    /** everything the channel maps depend on: detector parameters, SiPM channels and fibres of both planes **/
+    std::vector<std::pair<TString, Double_t>> ChannelMapParameters() const;
+    Bool_t ReadChannelMapCache();
+    void WriteChannelMapCache() const;
     ClassDef(MTCDetector, 3)
 };
 
@@ -6,7 +6,10 @@
 #pragma link off all functions;
 
 #pragma link C++ class MTCDetector+;
+#pragma link C++ class MTCChannelMap;
+#pragma link C++ struct MTCPlaneTransform;
 #pragma link C++ class MtcDetPoint+;
 #pragma link C++ class MtcDetHit+;
+#pragma link C++ class MtcDigitizer;
 
 #endif
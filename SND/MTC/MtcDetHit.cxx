@@ -12,11 +12,7 @@
 
 namespace
 {
-constexpr Float_t n_photons_min = 3.5f;
 constexpr Float_t n_photons_max = 104.0f;
-constexpr Float_t time_res = 150e-3f;     // 150 ps
-constexpr Float_t signal_speed = 15.0f;   // cm/ns
-const Float_t inv_signal_speed = 1.0f / signal_speed;
 // parameters for simulating the digitized information
 constexpr Float_t light_attenuation_params[2] = {20., 300.};                 // x_0, lambda
 constexpr Float_t n_pixels_to_qdc_params[4] = {0.172, -1.31, 0.006, 0.33};   // A, B, sigma_A, sigma_B
@@ -99,6 +95,15 @@ MtcDetHit::MtcDetHit(int SiPMChan, const std::vector<MtcDetPoint*>& points, cons
     time = gRandom->Gaus(earliest_to_A, time_res);
 }
 
+MtcDetHit::MtcDetHit(int SiPMChan, Float_t signal, Float_t hitTime, bool valid)
+    : ShipHit()
+{
+    fDetectorID = SiPMChan;
+    signals = signal;
+    time = hitTime;
+    flag = valid;
+}
+
 // -----   Destructor   ----------------------------------------------------
 MtcDetHit::~MtcDetHit() {}
 // -------------------------------------------------------------------------
@@ -19,6 +19,8 @@ class MtcDetHit : public ShipHit
     MtcDetHit& operator=(const MtcDetHit& hit) = default;
     //  Constructor from MtcDetPoint
     MtcDetHit(int detID, const std::vector<MtcDetPoint*>&, const std::vector<Float_t>&);
+    //  Constructor from the digitised signal and time, used by MtcDigitizer
+    MtcDetHit(int detID, Float_t signal, Float_t hitTime, bool valid);
 
     /** Destructor **/
     virtual ~MtcDetHit();
@@ -50,6 +52,14 @@ class MtcDetHit : public ShipHit
     Float_t GetEnergy();
     void setInvalid() { flag = false; }
     bool isValid() const { return flag; }
+    static constexpr Float_t n_photons_min = 3.5f;   ///< photons needed for a valid hit
+    static constexpr Float_t time_res = 150e-3f;     ///< 150 ps
+    static constexpr Float_t signal_speed = 15.0f;   ///< cm/ns
+    static constexpr Float_t inv_signal_speed = 1.0f / signal_speed;
+    /** response of the fibre readout, shared with MtcDigitizer **/
+    static Float_t light_attenuation(Float_t distance);
+    static Float_t sipm_saturation(Float_t ly);
+    static Float_t n_pixels_to_qdc(Float_t npix);
     /*
             SND@LHC comment: from Guido (22.9.2021): A threshold of 3.5pe should be used, which corresponds to 0.031MeV.
             1 SiPM channel has 104 pixels, pixel can only see 0 or >0 photons.
@@ -57,9 +67,6 @@ class MtcDetHit : public ShipHit
   private:
     Float_t signals = 0;
     Float_t time;
-    Float_t light_attenuation(Float_t distance);
-    Float_t sipm_saturation(Float_t ly);
-    Float_t n_pixels_to_qdc(Float_t npix);
     Float_t flag;   ///< flag
 
     ClassDef(MtcDetHit, 4);
@@ -0,0 +1,129 @@
+#include "MtcDigitizer.h"
+
+#include "FairLogger.h"
+#include "MTCChannelMap.h"
+#include "MTCDetector.h"
+#include "MtcDetPoint.h"
+#include "TClonesArray.h"
+#include "TMath.h"
+#include "TRandom.h"
+#include "TVector3.h"
+
+#include <algorithm>
+#include <limits>
+
+// -----   Default constructor   -------------------------------------------
+MtcDigitizer::MtcDigitizer(MTCDetector* detector)
+    : fDetector(detector)
+{}
+
+Int_t MtcDigitizer::Slot(Int_t channel, Bool_t scint)
+{
+    auto [it, inserted] = fSlotOf.try_emplace(channel, fChannel.size());
+    if (!inserted) {
+        return it->second;
+    }
+    fChannel.push_back(channel);
+    fScint.push_back(scint);
+    fLight.push_back(0.0f);
+    fEarliest.push_back(std::numeric_limits<Float_t>::max());
+    TVector3 sipmA, sipmB;
+    if (!scint) {
+        fDetector->GetSiPMPosition(channel, sipmA, sipmB);
+    }
+    fSiPM.insert(fSiPM.end(), {sipmB.X(), sipmB.Y(), sipmB.Z()});
+    return it->second;
+}
+
+// -----   Public method Exec   --------------------------------------------
+Int_t MtcDigitizer::Exec(TClonesArray* points, std::vector<MtcDetHit>& hits)
+{
+    fSlotOf.clear();
+    fChannel.clear();
+    fScint.clear();
+    fSiPM.clear();
+    fLight.clear();
+    fEarliest.clear();
+    fPairSlot.clear();
+    fPairSignal.clear();
+    fPairDistance.clear();
+    fPairTime.clear();
+    fPairArrival.clear();
+    if (!fDetector) {
+        LOG(ERROR) << "MtcDigitizer: no MTCDetector set";
+        return 0;
+    }
+    if (fDetector->GetChannelMapU().IsEmpty() && fDetector->GetChannelMapV().IsEmpty()) {
+        fDetector->SiPMmapping();
+    }
+
+    // (point, channel) pairs, scint points are summed directly
+    Int_t nPoints = points->GetEntriesFast();
+    for (Int_t k = 0; k < nPoints; k++) {
+        auto* pt = static_cast<MtcDetPoint*>(points->At(k));
+        Int_t det_id = pt->GetDetectorID();
+        Int_t station_type = pt->GetStationType();
+        if (station_type == 2) {
+            Int_t s = Slot(det_id, kTRUE);
+            fLight[s] += pt->GetEnergyLoss();
+            Float_t arrival = pt->GetTime();
+            fEarliest[s] = std::min(fEarliest[s], arrival);
+            continue;
+        }
+        if (station_type != 0 && station_type != 1) {
+            continue;
+        }
+        const MTCChannelMap& map = fDetector->GetChannelMap(det_id);
+        Int_t loc_fibre_id = det_id % 1000000;
+        Int_t f = map.FindFibre(loc_fibre_id);
+        if (f < 0) {
+            LOG(WARN) << "MTC digitization: no mapping found for fibre ID " << loc_fibre_id << " in station type "
+                      << station_type << ". Skipping.";
+            continue;
+        }
+        Float_t energy = pt->GetEnergyLoss();
+        for (Int_t c = map.GetFibreOffsets()[f]; c < map.GetFibreOffsets()[f + 1]; c++) {
+            Int_t global_channel = (det_id / 1000000) * 1000000 + map.GetChannels()[map.GetFibreChannels()[c]];
+            Int_t s = Slot(global_channel, kFALSE);
+            const Double_t* sipm = &fSiPM[3 * s];
+            Double_t dx = sipm[0] - pt->GetX();
+            Double_t dy = sipm[1] - pt->GetY();
+            Double_t dz = sipm[2] - pt->GetZ();
+            fPairSlot.push_back(s);
+            fPairSignal.push_back(energy * map.GetFibreWeights()[c]);
+            fPairDistance.push_back(TMath::Sqrt(dx * dx + dy * dy + dz * dz));
+            fPairTime.push_back(pt->GetTime());
+        }
+    }
+
+    // light yield after attenuation and arrival time at the SiPM of all pairs
+    size_t nPairs = fPairSlot.size();
+    for (size_t i = 0; i < nPairs; i++) {
+        Float_t light_yield = fPairSignal[i] * 1e6f * 0.16f;
+        light_yield *= MtcDetHit::light_attenuation(fPairDistance[i]);
+        fPairSignal[i] = light_yield;
+        Float_t arrival = fPairTime[i] + fPairDistance[i] * MtcDetHit::inv_signal_speed;
+        fPairArrival.push_back(arrival);
+    }
+    for (size_t i = 0; i < nPairs; i++) {
+        Int_t s = fPairSlot[i];
+        fLight[s] += fPairSignal[i];
+        fEarliest[s] = std::min(fEarliest[s], fPairArrival[i]);
+    }
+
+    // smearing, saturation and QDC per channel
+    size_t nSlots = fChannel.size();
+    hits.reserve(hits.size() + nSlots);
+    for (size_t s = 0; s < nSlots; s++) {
+        if (fScint[s]) {
+            hits.emplace_back(fChannel[s], fLight[s], gRandom->Gaus(fEarliest[s], MtcDetHit::time_res), true);
+            continue;
+        }
+        const Int_t smeared_light_yield = gRandom->Poisson(fLight[s]);
+        const Float_t n_pixels = MtcDetHit::sipm_saturation(smeared_light_yield);
+        Float_t signal = MtcDetHit::n_pixels_to_qdc(n_pixels);
+        Float_t time = gRandom->Gaus(fEarliest[s], MtcDetHit::time_res);
+        hits.emplace_back(fChannel[s], signal, time, smeared_light_yield > MtcDetHit::n_photons_min);
+    }
+    return nSlots;
+}
@@ -0,0 +1,57 @@
+#ifndef SND_MTC_MTCDIGITIZER_H_
+#define SND_MTC_MTCDIGITIZER_H_ 1
+
+#include "MtcDetHit.h"
+#include "Rtypes.h"
+
+#include <unordered_map>
+#include <vector>
+
+class MTCDetector;
+class TClonesArray;
+
+/**
+ ** Digitisation of all MtcDetPoints of an event in one call, same response as
+ ** MtcDetHit(SiPMChan, points, weights):
+ **  - fibre points are shared between the SiPM channels seeing the fibre, with the
+ **    weights of the MTCDetector channel map, scint points go to their own cell
+ **  - light yield with attenuation and arrival time are computed for all
+ **    (point, channel) pairs in one flat loop and summed per channel
+ **  - Poisson smearing, SiPM saturation, QDC conversion and time smearing per channel
+ ** Channels are filled in the order they are first hit, as in the former python loop,
+ ** so that the random numbers are drawn in the same order.
+ **/
+class MtcDigitizer
+{
+  public:
+    explicit MtcDigitizer(MTCDetector* detector = nullptr);
+    virtual ~MtcDigitizer() = default;
+
+    void SetDetector(MTCDetector* detector) { fDetector = detector; }
+
+    /** Append one MtcDetHit per channel with signal to hits, returns the number of hits added **/
+    Int_t Exec(TClonesArray* points, std::vector<MtcDetHit>& hits);
+
+  private:
+    /** slot of the global channel, created on first use **/
+    Int_t Slot(Int_t channel, Bool_t scint);
+
+    MTCDetector* fDetector;
+    std::unordered_map<Int_t, Int_t> fSlotOf;   ///< global channel -> slot, per event
+
+    // per slot
+    std::vector<Int_t> fChannel;
+    std::vector<Bool_t> fScint;
+    std::vector<Double_t> fSiPM;   ///< x, y, z of the far end (B) of the SiPM channel
+    std::vector<Float_t> fLight;
+    std::vector<Float_t> fEarliest;
+
+    // per (point, channel) pair
+    std::vector<Int_t> fPairSlot;
+    std::vector<Float_t> fPairSignal;
+    std::vector<Float_t> fPairDistance;
+    std::vector<Double_t> fPairTime;     ///< point time
+    std::vector<Float_t> fPairArrival;   ///< arrival time at the SiPM
+};
+
+#endif   // SND_MTC_MTCDIGITIZER_H_
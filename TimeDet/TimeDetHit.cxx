@@ -16,6 +16,45 @@ using std::endl;
 
 Double_t speedOfLight = TMath::C() *100./1000000000.0 ; // from m/sec to cm/ns
 
+static std::vector<TimeDetBarTransform> barTransforms; // bar transforms by detector ID
+static TGeoManager* barTransformGeo = nullptr;         // geometry of barTransforms
+
+// ---- table of the bar transforms, taken from the geometry once
+static void BuildBarTransforms()
+{
+  barTransforms.clear();
+  barTransformGeo = gGeoManager;
+  TGeoVolume* det = gGeoManager ? gGeoManager->FindVolumeFast("Timing Detector") : nullptr;
+  if (!det || !det->GetNodes()) return;
+  TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
+  nav->PushPath();
+  for (Int_t i = 0; i < det->GetNodes()->GetEntriesFast(); i++) {
+    TGeoNode* bar = (TGeoNode*)det->GetNodes()->At(i);
+    Int_t id = bar->GetNumber();
+    TString path = "/Timing Detector_1/TimeDet_";path+=id;
+    if (id < 0 || !nav->cd(path)) continue;
+    auto shape =  dynamic_cast<TGeoBBox*>(nav->GetCurrentNode()->GetVolume()->GetShape());
+    if (!shape) continue;
+    if (id >= (Int_t)barTransforms.size()) barTransforms.resize(id+1, TimeDetBarTransform{{0,0,0},{0,0,0},kFALSE});
+    TimeDetBarTransform& t = barTransforms[id];
+    Double_t origin[3] = {shape->GetOrigin()[0],shape->GetOrigin()[1],shape->GetOrigin()[2]};
+    nav->LocalToMaster(origin,t.centre);
+    t.half[0] = shape->GetDX();
+    t.half[1] = shape->GetDY();
+    t.half[2] = shape->GetDZ();
+    t.valid = kTRUE;
+  }
+  nav->PopPath();
+}
+
+const TimeDetBarTransform* TimeDetHit::GetBarTransform(Int_t detID)
+{
+  // scanned once per geometry, also when it has no timing detector
+  if (barTransformGeo != gGeoManager) BuildBarTransforms();
+  if (detID < 0 || detID >= (Int_t)barTransforms.size() || !barTransforms[detID].valid) return nullptr;
+  return &barTransforms[detID];
+}
+
 
 // -----   Default constructor   --------------
 TimeDetHit::TimeDetHit()
@@ -61,8 +100,9 @@ std::vector<double>  TimeDetHit::GetTime(Double_t x){
 }
 // ---- return mean time information
 std::vector<double>  TimeDetHit::GetTime(){
-     TGeoBBox* shape =  (TGeoBBox*)gGeoManager->GetVolume("TimeDet")->GetShape();
-     Double_t t0  =  (t_1+t_2)/2.-shape->GetDX()/v_drift;
+     const TimeDetBarTransform* bar = GetBarTransform(fDetectorID);
+     Double_t dx = bar ? bar->half[0] : ((TGeoBBox*)gGeoManager->GetVolume("TimeDet")->GetShape())->GetDX();
+     Double_t t0  =  (t_1+t_2)/2.-dx/v_drift;
      Float_t lpos, lneg;
      lneg = (t_1-t0)*v_drift;
      lpos = (t_2-t0)*v_drift;
@@ -89,15 +129,24 @@ std::vector<double> TimeDetHit::GetMeasurements(){
 
 // distance to edges
 void TimeDetHit::Dist(Float_t x, Float_t& lpos, Float_t& lneg){
-     TGeoNode* node  = GetNode();
-     auto shape =  dynamic_cast<TGeoBBox*>(node->GetVolume()->GetShape());
+     const TimeDetBarTransform* bar = GetBarTransform(fDetectorID);
+     Double_t dx;
+     if (bar) {
+       dx = bar->half[0];
+     } else {
+       TGeoNode* node  = GetNode();
+       dx = dynamic_cast<TGeoBBox*>(node->GetVolume()->GetShape())->GetDX();
+     }
      TVector3 pos    = GetXYZ();
-     lpos = TMath::Abs( pos.X() + shape->GetDX() - x );
-     lneg = TMath::Abs( pos.X() - shape->GetDX() - x );
+     lpos = TMath::Abs( pos.X() + dx - x );
+     lneg = TMath::Abs( pos.X() - dx - x );
 }
 // ----------------------------------------------
 TVector3 TimeDetHit::GetXYZ()
 {
+    const TimeDetBarTransform* bar = GetBarTransform(fDetectorID);
+    if (bar) return TVector3(bar->centre[0],bar->centre[1],bar->centre[2]);
+    // bar not in the table, navigate as before
     TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
     TGeoNode* node = GetNode();
     auto shape =  dynamic_cast<TGeoBBox*>(node->GetVolume()->GetShape());
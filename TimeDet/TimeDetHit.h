@@ -7,6 +7,15 @@
 #include "TGeoShape.h"
 #include "TGeoPhysicalNode.h"
 
+#include <vector>
+
+/** Global centre and half sizes of one timing detector bar **/
+struct TimeDetBarTransform
+{
+    Double_t centre[3];   ///< bar centre in the global frame
+    Double_t half[3];     ///< half sizes of the bar
+    Bool_t valid;         ///< bar present in the geometry
+};
 
 class TimeDetHit : public ShipHit
 {
@@ -31,6 +40,8 @@ class TimeDetHit : public ShipHit
     Double_t GetZ();
     TVector3 GetXYZ();
     TGeoNode* GetNode();
+    /** transform of the bar, from a table built once per geometry, nullptr if unknown **/
+    static const TimeDetBarTransform* GetBarTransform(Int_t detID);
     std::vector<double> GetTime(Double_t x);
     std::vector<double> GetTime();
     std::vector<double> GetMeasurements();
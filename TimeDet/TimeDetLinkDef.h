@@ -7,5 +7,6 @@
 #pragma link C++ class TimeDet+;
 #pragma link C++ class TimeDetPoint+;
 #pragma link C++ class TimeDetHit+;
+#pragma link C++ struct TimeDetBarTransform;
 
 #endif
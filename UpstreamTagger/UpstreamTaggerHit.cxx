@@ -21,6 +21,32 @@ using std::endl;
 
 Double_t speedOfLight = TMath::C() *100./1000000000.0 ; // from m/sec to cm/ns
 
+static Double_t taggerCentre[3] = {0,0,0};     // global centre of the tagger box
+static Bool_t taggerFound = kFALSE;            // tagger present in the geometry
+static TGeoManager* taggerGeo = nullptr;       // geometry of taggerCentre
+
+// ---- centre of the tagger, taken from the geometry once
+static const Double_t* TaggerCentre()
+{
+  // scanned once per geometry, also when it has no tagger
+  if (taggerGeo == gGeoManager) return taggerFound ? taggerCentre : nullptr;
+  taggerGeo = gGeoManager;
+  taggerFound = kFALSE;
+  if (!gGeoManager) return nullptr;
+  TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
+  nav->PushPath();
+  if (nav->cd("/Upstream_Tagger_1")) {
+    auto shape = dynamic_cast<TGeoBBox*>(nav->GetCurrentNode()->GetVolume()->GetShape());
+    if (shape) {
+      Double_t origin[3] = {shape->GetOrigin()[0],shape->GetOrigin()[1],shape->GetOrigin()[2]};
+      nav->LocalToMaster(origin,taggerCentre);
+      taggerFound = kTRUE;
+    }
+  }
+  nav->PopPath();
+  return taggerFound ? taggerCentre : nullptr;
+}
+
 // -----   Default constructor   --------------
 UpstreamTaggerHit::UpstreamTaggerHit()
   : ShipHit()
@@ -55,6 +81,10 @@ void UpstreamTaggerHit::Dist(Float_t x, Float_t& lpos, Float_t& lneg){
 // ----------------------------------------------
 TVector3 UpstreamTaggerHit::GetXYZ()
 {
+  // single box, the same position for all detector IDs
+  const Double_t* centre = TaggerCentre();
+  if (!centre) return TVector3();
+  return TVector3(centre[0],centre[1],centre[2]);
 }
 
 
@@ -92,6 +92,7 @@ ecal::ecal()
     fNRows(0),
     fVolIdMax(0),
     fFirstNumber(0),
+    fHitIndex(),
     fVolArr(),
     fModules(),
     fCells(),
@@ -105,7 +106,12 @@ ecal::ecal()
     fHolePos(),
     fModulesWithType(),
     fRawNumber(),
-    fStructureId()
+    fStructureId(),
+    fEcalVolId(-1),
+    fCellsPerModule(1),
+    fCellType(),
+    fCellX0(),
+    fCellY0()
 {
   fVerboseLevel = 1;
 
@@ -168,6 +174,7 @@ ecal::ecal(const char* name, Bool_t active, const char* fileGeo)
     fNRows(0),
     fVolIdMax(0),
     fFirstNumber(0),
+    fHitIndex(),
     fVolArr(),
     fModules(),
     fCells(),
@@ -181,7 +188,12 @@ ecal::ecal(const char* name, Bool_t active, const char* fileGeo)
     fHolePos(),
     fModulesWithType(),
     fRawNumber(),
-    fStructureId()
+    fStructureId(),
+    fEcalVolId(-1),
+    fCellsPerModule(1),
+    fCellType(),
+    fCellX0(),
+    fCellY0()
 {
   /** ecal constructor:
    ** reads geometry parameters from the ascii file <fileGeo>,
@@ -289,6 +301,8 @@ ecal::ecal(const char* name, Bool_t active, const char* fileGeo)
 void ecal::Initialize()
 {
   FairDetector::Initialize();
+  /** compared to gMC->CurrentVolID in ProcessHits instead of the volume name **/
+  fEcalVolId=gMC->VolId("Ecal");
 /*
   FairRun* sim = FairRun::Instance();
   FairRuntimeDb* rtdb=sim->GetRuntimeDb();
@@ -338,6 +352,7 @@ void ecal::SetEcalCuts(Int_t medium)
 void ecal::FinishPrimary()
 {
   fFirstNumber=fLiteCollection->GetEntriesFast();
+  fHitIndex.clear();
 }
 
 //_____________________________________________________________________________
@@ -384,7 +399,6 @@ void ecal::SetSpecialPhysicsCuts()
 Bool_t  ecal::ProcessHits(FairVolume* vol)
 {
   /** Fill MC point for sensitive ECAL volumes **/
-  TString Ecal="Ecal";
   fELoss   = gMC->Edep();
   fTrackID = gMC->GetStack()->GetCurrentTrackNumber();
   fTime    = gMC->TrackTime()*1.0e09;
@@ -396,7 +410,7 @@ Bool_t  ecal::ProcessHits(FairVolume* vol)
   gMC->CurrentVolID(volID);
   //cout <<"Ecal called  "<<volID<<" "<<vol->getVolumeId()<<" "<<fStructureId<<" "<<fELoss*1e10<<" "<<gGeoManager->GetVolume(vol->getVolumeId())->GetName()<<" "<<gMC->CurrentVolName()<<" "<<bz<<endl;
   //if (vol->getVolumeId()==fStructureId) {
-  if (Ecal.CompareTo(gMC->CurrentVolName())==0) {
+  if (volID==fEcalVolId) {
     if (gMC->IsTrackEntering()) {
       FillWallPoint();
       //cout <<"fill wallpoint "<<vol->getVolumeId()<<" "<<fStructureId<<" "<<fELoss*1e10<<endl;
@@ -451,7 +465,7 @@ Bool_t  ecal::ProcessHits(FairVolume* vol)
     }
     Int_t id=(my*100+mx)*100+cell+1;
     if (id<0){
-      if (Ecal.CompareTo(gMC->CurrentVolName())==0&&fELoss<1e-19)
+      if (volID==fEcalVolId&&fELoss<1e-19)
        return kTRUE;
       cout << "neg id "<<mx<<" "<<my<<" "<<cell<<" "<<gMC->CurrentVolName()<<" "<<gMC->CurrentVolOffName(1)<<" "<<gMC->CurrentVolOffName(2)<<" "<<fELoss<<" "<<fELoss*1e10<<endl;
     }
@@ -473,6 +487,21 @@ Bool_t  ecal::ProcessHits(FairVolume* vol)
     }
 */
     fVolumeID=id;
+    Int_t n=(my*fXSize+mx)*fCellsPerModule+cell;
+    if (fSimpleGeo==0&&mx>=0&&mx<fXSize&&my>=0&&my<fYSize&&cell>=0&&cell<fCellsPerModule
+        &&n<(Int_t)fCellType.size()&&fCellType[n]>0)
+    {
+      /** tile corner and type from the cell table **/
+      type=fCellType[n];
+      px=(x-fCellX0[n])/fXCell[type];
+      py=(y-fCellY0[n])/fYCell[type];
+      if (px>=0&&px<1&&py>=0&&py<1)
+      {
+        fELoss*=fLightMaps[type]->Data(px-0.5, py-0.5);
+        FillLitePoint(0);
+      }
+    }
+    else
     if (fSimpleGeo==0)
     {
       type=fInf->GetType(mx, my);
@@ -552,13 +581,11 @@ void ecal::FillWallPoint()
 
 ecalPoint* ecal::FindHit(Int_t VolId, Int_t TrackId)
 {
-  for(Int_t i=fFirstNumber;i<fLiteCollection->GetEntriesFast();i++)
-  {
-    ecalPoint* point=(ecalPoint*)fLiteCollection->At(i);
-    if (point->GetTrackID()==TrackId&&point->GetDetectorID()==VolId)
-      return point;
-  }
-  return NULL;
+  /** Only hits of the current primary are indexed **/
+  std::unordered_map<Long64_t, Int_t>::const_iterator p=fHitIndex.find(HitKey(VolId, TrackId));
+  if (p==fHitIndex.end())
+    return NULL;
+  return (ecalPoint*)fLiteCollection->At(p->second);
 }
 //-----------------------------------------------------------------------------
 Bool_t ecal::FillLitePoint(Int_t volnum)
@@ -594,8 +621,11 @@ Bool_t ecal::FillLitePoint(Int_t volnum)
   if ((oldHit=FindHit(fVolumeID,fTrackID))!=NULL)
     ChangeHit(oldHit);
   else
+  {
     // Create ecalPoint for scintillator volumes
     newHit = AddLiteHit(fTrackID, fVolumeID, fTime, fELoss);
+    fHitIndex[HitKey(fVolumeID, fTrackID)]=fLiteCollection->GetEntriesFast()-1;
+  }
 
 
   return kTRUE;
@@ -609,6 +639,7 @@ void ecal::EndOfEvent() {
   fLiteCollection->Clear();
   fPosIndex = 0;
   fFirstNumber=0;
+  fHitIndex.clear();
 }
 // -------------------------------------------------------------------------
 
@@ -628,6 +659,7 @@ void ecal::Reset()
   fLiteCollection->Clear();
   ResetParameters();
   fFirstNumber=0;
+  fHitIndex.clear();
 }
 // -------------------------------------------------------------------------
 
@@ -769,6 +801,44 @@ void ecal::ConstructGeometry()
 //TODO:
 //Should move the guarding volume, not structure itself
   gGeoManager->Node("EcalStructure", 1, "Ecal", fDX, fDY, 0.0, 0, kTRUE, buf, 0);
+  BuildCellTable();
+}
+// -------------------------------------------------------------------------
+
+// -----   Private method BuildCellTable   ---------------------------------
+void ecal::BuildCellTable()
+{
+  Int_t mx;
+  Int_t my;
+  Int_t cell;
+  Int_t type;
+  Int_t cx;
+  Int_t cy;
+  Int_t n;
+
+  fCellsPerModule=1;
+  for(type=1;type<cMaxModuleType;type++)
+    if (fModulesWithType[type]>0&&type*type>fCellsPerModule) fCellsPerModule=type*type;
+  n=fXSize*fYSize*fCellsPerModule;
+  fCellType.assign(n, 0);
+  fCellX0.assign(n, 0);
+  fCellY0.assign(n, 0);
+  for(my=0;my<fYSize;my++)
+  for(mx=0;mx<fXSize;mx++)
+  {
+    type=fInf->GetType(mx, my);
+    if (type<=0) continue;
+    for(cell=0;cell<type*type;cell++)
+    {
+      n=(my*fXSize+mx)*fCellsPerModule+cell;
+      cx=cell%type;
+      cy=cell/type;
+      /** same expressions as the former ProcessHits **/
+      fCellType[n]=type;
+      fCellX0[n]=mx*fModuleSize-fEcalSize[0]/2.0+fXCell[type]*cx+(2*cx+1)*fEdging+fThicknessSteel;
+      fCellY0[n]=my*fModuleSize-fEcalSize[1]/2.0+fYCell[type]*cy+(2*cy+1)*fEdging+fThicknessSteel;
+    }
+  }
 }
 // -------------------------------------------------------------------------
 
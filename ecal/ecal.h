@@ -20,6 +20,8 @@
 #include "TVector3.h"
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 class ecalPoint;
 class FairVolume;
@@ -105,6 +107,9 @@ private:
   void ResetParameters();
   void SetEcalCuts(Int_t medium);
   ecalPoint* FindHit(Int_t VolId, Int_t TrackId);
+  /** Key of the hit index for given volume and track **/
+  static Long64_t HitKey(Int_t VolId, Int_t TrackId)
+    {return (((Long64_t)VolId)<<32)|((UInt_t)TrackId);}
 
 private:
   ecalInf*  fInf;			//!
@@ -202,6 +207,9 @@ private:
   Int_t   fVolIdMax;			//!
   /** Number of first hit for current primary **/
   Int_t fFirstNumber;			//!
+  /** Index in fLiteCollection of the hits of the current primary,
+   ** keyed by HitKey(volume ID, track ID) **/
+  std::unordered_map<Long64_t, Int_t> fHitIndex;	//!
   /** Map of volumes in ECAL
    ** fVolArr[0]==code of sensivite wall
    ** fVolArr[1]==code of PS Lead
@@ -242,6 +250,17 @@ private:
 
   /** Volume ID of calorimeter structure **/
   Int_t fStructureId;			//!
+  /** MC volume ID of the calorimeter volume, resolved in Initialize **/
+  Int_t fEcalVolId;			//!
+  /** Cells per module in the cell table, square of the largest module type **/
+  Int_t fCellsPerModule;		//!
+  /** (my*fXSize+mx)*fCellsPerModule+cell -> module type (0 if no such cell)
+   ** and lower left corner of the scintillator tile **/
+  std::vector<Char_t> fCellType;	//!
+  std::vector<Double_t> fCellX0;	//!
+  std::vector<Double_t> fCellY0;	//!
+  /** Fill the cell table from the geometry container **/
+  void BuildCellTable();
   /** Initialize medium with given name **/
   Int_t InitMedium(const char* name);
   /** Initialize all calorimter media **/
@@ -15,6 +15,7 @@
 
 #include <iostream>
 #include <list>
+#include <vector>
 
 using namespace std;
 
@@ -23,9 +24,16 @@ void ecalClusterFinder::Exec(Option_t* option)
 {
   fEv++;
 
+  FormPreClustersFlat();
+  FormClustersFlat();
+  if (!fRegression) return;
+
+  /** Same event with the list based finder **/
+  if (!fRefClusters) fRefClusters=new TClonesArray("ecalCluster", 2000);
   ClearPreClusters();
   FormPreClusters();
-  FormClusters();
+  FormClusters(fRefClusters);
+  if (!CompareClusters()) fNMismatches++;
 }
 
 InitStatus ecalClusterFinder::Init()
@@ -85,6 +93,12 @@ ecalClusterFinder::~ecalClusterFinder()
     fClusters->Delete();
     delete fClusters;
   }
+  if (fRefClusters)
+  {
+    fRefClusters->Delete();
+    delete fRefClusters;
+  }
+  ClearPreClusters();
 }
 
 /** Form a preclusters.
@@ -141,10 +155,10 @@ void ecalClusterFinder::FormPreClusters()
 }
 
 /** Form clusters from precluster **/
-void ecalClusterFinder::FormClusters()
+void ecalClusterFinder::FormClusters(TClonesArray* clusters)
 {
   /** ecalCluster needs a destructor call :-( **/
-  fClusters->Delete();
+  clusters->Delete();
   Int_t fN=0;
   list<ecalPreCluster*>::const_iterator p1=fPreClusters.begin();
   list<ecalPreCluster*>::const_iterator p2;
@@ -198,6 +212,201 @@ void ecalClusterFinder::FormClusters()
     if ((Int_t)cluster.size()>MaxSize)
       MaxSize=cluster.size();
     if (max>Maximums) Maximums=max;
+    ecalCluster* cls=new ((*clusters)[fN]) ecalCluster(fN, cluster, maxs); fN++;
+    cls->fPreCalibrated=fCalib->Calibrate(type, cls->fEnergy);
+  }
+  if (fVerbose>0)
+  {
+    Info("FormClusters", "Total %d clusters formed.", fN);
+    Info("FormClusters", "Maximum size of cluster is %d cells.",  MaxSize);
+    Info("FormClusters", "Maximum number of photons per cluster is %d.",  Maximums);
+  }
+}
+
+/** 5x5 cluster of every cell of the structure as dense cell indices.
+ ** Same cells in the same order as ecalCell::Get5x5Cluster. **/
+void ecalClusterFinder::BuildNeighbours()
+{
+  Int_t n=fStr->GetNCellIndices();
+  list<ecalCell*> cls;
+  list<ecalCell*>::const_iterator p;
+  Int_t i;
+  Int_t j;
+
+  f5x5Offsets.assign(1, 0);
+  f5x5Cells.clear();
+  for(i=0;i<n;i++)
+  {
+    ecalCell* cell=fStr->GetCellByIndex(i);
+    if (cell)
+    {
+      cell->Get5x5Cluster(cls);
+      for(p=cls.begin();p!=cls.end();++p)
+      {
+        j=fStr->GetCellIndex((*p)->GetCellNumber());
+        if (j<0)
+        {
+          Error("BuildNeighbours", "Cell %d is not in the calorimeter structure.", (*p)->GetCellNumber());
+          continue;
+        }
+        f5x5Cells.push_back(j);
+      }
+    }
+    f5x5Offsets.push_back(f5x5Cells.size());
+  }
+  fCellOwner.assign(n, -1);
+  fInCluster.assign(n, 0);
+  fNeighbourStr=fStr;
+}
+
+/** Form a preclusters, as FormPreClusters but the cells are
+ ** copied from the 5x5 neighbour table **/
+void ecalClusterFinder::FormPreClustersFlat()
+{
+  if (fNeighbourStr!=fStr||(Int_t)f5x5Offsets.size()!=fStr->GetNCellIndices()+1)
+    BuildNeighbours();
+
+  Int_t nm=fMaximums->GetEntriesFast();
+  Int_t i;
+  Int_t k;
+  Int_t c;
+  ecalMaximum* max;
+  ecalCell* cell;
+  Double_t ecls;
+
+  fPreOffsets.assign(1, 0);
+  fPreCells.clear();
+  fPreMax.clear();
+  for(i=0;i<nm;i++)
+  {
+    max=(ecalMaximum*)fMaximums->At(i);
+    if (max==NULL) continue;
+    /** Remove maximums matched with charged tracks **/
+    if (max->Mark()!=0) continue;
+    cell=max->Cell();
+    ecls=cell->GetEnergy();
+    /** Remove low energy maximums **/
+    if (ecls<fMinMaxE) continue;
+    c=fStr->GetCellIndex(cell->GetCellNumber());
+    if (c<0) continue;
+    ecls=0.0;
+    for(k=f5x5Offsets[c];k<f5x5Offsets[c+1];k++)
+      ecls+=fStr->GetCellByIndex(f5x5Cells[k])->GetEnergy();
+    /** Remove low energy clusters **/
+    if (ecls<fMinClusterE) continue;
+    fPreCells.insert(fPreCells.end(), f5x5Cells.begin()+f5x5Offsets[c], f5x5Cells.begin()+f5x5Offsets[c+1]);
+    fPreOffsets.push_back(fPreCells.size());
+    fPreMax.push_back(max);
+  }
+}
+
+Int_t ecalClusterFinder::FindRoot(Int_t i)
+{
+  Int_t root=i;
+  while(fParent[root]!=root) root=fParent[root];
+  while(fParent[i]!=root)
+  {
+    Int_t next=fParent[i];
+    fParent[i]=root;
+    i=next;
+  }
+  return root;
+}
+
+/** Form clusters from preclusters.
+ ** Preclusters with common cells are joined with union-find, the root is
+ ** always the first precluster of the group. Inside a group the passes of
+ ** FormClusters are replayed, so cells and maximums of the clusters come
+ ** in the same order and the clusters are identical. **/
+void ecalClusterFinder::FormClustersFlat()
+{
+  /** ecalCluster needs a destructor call :-( **/
+  fClusters->Delete();
+  Int_t np=fPreMax.size();
+  Int_t fN=0;
+  Int_t MaxSize=0;
+  Int_t Maximums=0;
+  Int_t i;
+  Int_t j;
+  Int_t k;
+  Int_t c;
+  Int_t a;
+  Int_t b;
+  Int_t type;
+  Bool_t grown;
+  Bool_t common;
+  list<ecalCell*> cluster;
+  list<ecalMaximum*> maxs;
+  vector<Int_t> cells;
+
+  if (fVerbose>9)
+  {
+    Info("FormClusters", "Total %d preclusters found.", np);
+  }
+  fParent.resize(np);
+  for(i=0;i<np;i++) fParent[i]=i;
+  for(i=0;i<np;i++)
+  for(k=fPreOffsets[i];k<fPreOffsets[i+1];k++)
+  {
+    c=fPreCells[k];
+    if (fCellOwner[c]>=0)
+    {
+      a=FindRoot(fCellOwner[c]); b=FindRoot(i);
+      if (a<b) fParent[b]=a; else if (b<a) fParent[a]=b;
+    }
+    fCellOwner[c]=i;
+  }
+  for(k=0;k<(Int_t)fPreCells.size();k++)
+    fCellOwner[fPreCells[k]]=-1;
+
+  /** Members of every group in ascending order, groups ordered by root **/
+  vector<Int_t> count(np+1, 0);
+  vector<Int_t> members(np);
+  for(i=0;i<np;i++) count[FindRoot(i)+1]++;
+  for(i=0;i<np;i++) count[i+1]+=count[i];
+  vector<Int_t> next(count.begin(), count.end()-1);
+  for(i=0;i<np;i++) members[next[fParent[i]]++]=i;
+  vector<Char_t> merged(np, 0);
+
+  for(i=0;i<np;i++)
+  {
+    if (fParent[i]!=i) continue;
+    cells.assign(fPreCells.begin()+fPreOffsets[i], fPreCells.begin()+fPreOffsets[i+1]);
+    for(k=0;k<(Int_t)cells.size();k++) fInCluster[cells[k]]=1;
+    maxs.clear(); maxs.push_back(fPreMax[i]);
+    type=fPreMax[i]->Cell()->GetType();
+    do
+    {
+      grown=kFALSE;
+      for(j=count[i]+1;j<count[i+1];j++)
+      {
+        b=members[j];
+        if (merged[b]) continue;
+        common=kFALSE;
+        for(k=fPreOffsets[b];k<fPreOffsets[b+1];k++)
+          if (fInCluster[fPreCells[k]]) { common=kTRUE; break; }
+        if (!common) continue;
+        merged[b]=1;
+        for(k=fPreOffsets[b];k<fPreOffsets[b+1];k++)
+        {
+          c=fPreCells[k];
+          if (fInCluster[c]) continue;
+          fInCluster[c]=1; cells.push_back(c); grown=kTRUE;
+        }
+        maxs.push_back(fPreMax[b]);
+      }
+    }
+    while(grown);
+
+    cluster.clear();
+    for(k=0;k<(Int_t)cells.size();k++)
+    {
+      cluster.push_back(fStr->GetCellByIndex(cells[k]));
+      fInCluster[cells[k]]=0;
+    }
+    if ((Int_t)cluster.size()>MaxSize)
+      MaxSize=cluster.size();
+    if ((Int_t)maxs.size()>Maximums) Maximums=maxs.size();
     ecalCluster* cls=new ((*fClusters)[fN]) ecalCluster(fN, cluster, maxs); fN++;
     cls->fPreCalibrated=fCalib->Calibrate(type, cls->fEnergy);
   }
@@ -209,6 +418,36 @@ void ecalClusterFinder::FormClusters()
   }
 }
 
+/** Compare clusters of both finders, kTRUE if identical **/
+Bool_t ecalClusterFinder::CompareClusters()
+{
+  Int_t n=fClusters->GetEntriesFast();
+  Int_t i;
+  Int_t j;
+  ecalCluster* c1;
+  ecalCluster* c2;
+
+  if (n!=fRefClusters->GetEntriesFast())
+  {
+    Error("CompareClusters", "Event %d: %d clusters formed, list based finder gives %d.", fEv, n, fRefClusters->GetEntriesFast());
+    return kFALSE;
+  }
+  for(i=0;i<n;i++)
+  {
+    c1=(ecalCluster*)fClusters->At(i);
+    c2=(ecalCluster*)fRefClusters->At(i);
+    Bool_t same=c1->Size()==c2->Size()&&c1->Maxs()==c2->Maxs()&&c1->Energy()==c2->Energy();
+    for(j=0;same&&j<c1->Size();j++)
+      same=c1->CellNum(j)==c2->CellNum(j);
+    for(j=0;same&&j<c1->Maxs();j++)
+      same=c1->PeakNum(j)==c2->PeakNum(j);
+    if (same) continue;
+    Error("CompareClusters", "Event %d: cluster %d differs from the list based finder.", fEv, i);
+    return kFALSE;
+  }
+  return kTRUE;
+}
+
 /** Clear a preclusters list **/
 void ecalClusterFinder::ClearPreClusters()
 {
@@ -228,7 +467,19 @@ ecalClusterFinder::ecalClusterFinder(const char* name, const Int_t verbose)
     fInf(NULL),
     fPreClusters(),
     fMinClusterE(0.03),
-    fMinMaxE(0.015)
+    fMinMaxE(0.015),
+    fRegression(kFALSE),
+    fRefClusters(NULL),
+    fNMismatches(0),
+    fNeighbourStr(NULL),
+    f5x5Offsets(),
+    f5x5Cells(),
+    fPreOffsets(),
+    fPreCells(),
+    fPreMax(),
+    fParent(),
+    fCellOwner(),
+    fInCluster()
 {
   ;
 }
@@ -244,7 +495,19 @@ ecalClusterFinder::ecalClusterFinder()
     fInf(NULL),
     fPreClusters(),
     fMinClusterE(0.03),
-    fMinMaxE(0.015)
+    fMinMaxE(0.015),
+    fRegression(kFALSE),
+    fRefClusters(NULL),
+    fNMismatches(0),
+    fNeighbourStr(NULL),
+    f5x5Offsets(),
+    f5x5Cells(),
+    fPreOffsets(),
+    fPreCells(),
+    fPreMax(),
+    fParent(),
+    fCellOwner(),
+    fInCluster()
 {
   ;
 }
@@ -6,6 +6,7 @@
 
 #include "FairTask.h"
 #include <list>
+#include <vector>
 
 class TClonesArray;
 class ecalStructure;
@@ -43,13 +44,26 @@ public:
   void SetMinMaxE(Double_t minmaxe=0.015) {fMinMaxE=minmaxe;}
   /** Minimum uncalibrated energy of precluster maximum for consideration **/
   void SetMinClusterE(Double_t minmaxe=0.03) {fMinClusterE=minmaxe;}
+  /** Also run the list based finder and compare its clusters to the ones produced **/
+  void SetRegressionMode(Bool_t regression=kTRUE) {fRegression=regression;}
+  /** Number of events with different clusters in regression mode **/
+  Int_t GetNMismatches() const {return fNMismatches;}
 private:
-  /** Form clusters from precluster **/
-  void FormClusters();
-  /** Form a preclusters **/
+  /** Form clusters from precluster, list based version **/
+  void FormClusters(TClonesArray* clusters);
+  /** Form a preclusters, list based version **/
   void FormPreClusters();
   /** Clear a preclusters list **/
   void ClearPreClusters();
+  /** 5x5 cluster of every cell as dense cell indices, once per structure **/
+  void BuildNeighbours();
+  /** Form a preclusters as index ranges into fPreCells **/
+  void FormPreClustersFlat();
+  /** Form clusters from the preclusters sharing cells with union-find **/
+  void FormClustersFlat();
+  Int_t FindRoot(Int_t i);
+  /** Compare fClusters to fRefClusters **/
+  Bool_t CompareClusters();
   /** Current event **/
   Int_t fEv;
 
@@ -73,11 +87,31 @@ private:
   Double_t fMinClusterE;
   /** Minimum uncalibrated energy of precluster maximum for consideration **/
   Double_t fMinMaxE;
+  /** Compare to the list based finder **/
+  Bool_t fRegression;
+  /** Clusters of the list based finder in regression mode **/
+  TClonesArray* fRefClusters;		//!
+  Int_t fNMismatches;
+
+  /** Structure the neighbours were taken from **/
+  ecalStructure* fNeighbourStr;		//!
+  /** dense cell index -> 5x5 cluster cells in f5x5Cells[f5x5Offsets[i]..f5x5Offsets[i+1]) **/
+  std::vector<Int_t> f5x5Offsets;	//!
+  std::vector<Int_t> f5x5Cells;		//!
+  /** preclusters: cells in fPreCells[fPreOffsets[k]..fPreOffsets[k+1]) and maximum **/
+  std::vector<Int_t> fPreOffsets;	//!
+  std::vector<Int_t> fPreCells;		//!
+  std::vector<ecalMaximum*> fPreMax;	//!
+  /** union-find parents of the preclusters **/
+  std::vector<Int_t> fParent;		//!
+  /** per dense cell index: last precluster containing it, cell already in current cluster **/
+  std::vector<Int_t> fCellOwner;	//!
+  std::vector<Char_t> fInCluster;	//!
 
   ecalClusterFinder(const ecalClusterFinder&);
   ecalClusterFinder& operator=(const ecalClusterFinder&);
 
-  ClassDef(ecalClusterFinder, 1)
+  ClassDef(ecalClusterFinder, 2)
 };
 
 #endif
@@ -14,6 +14,25 @@
 
 using namespace std;
 
+namespace {
+/** SplitMix64 finalizer: a counter based generator, the n-th number of a stream is Mix(key+n) **/
+inline ULong64_t Mix(ULong64_t x)
+{
+  x=(x^(x>>30))*0xBF58476D1CE4E5B9ULL;
+  x=(x^(x>>27))*0x94D049BB133111EBULL;
+  return x^(x>>31);
+}
+
+/** Standard normal number from two counters, Box-Muller **/
+inline Double_t CounterGaus(ULong64_t key)
+{
+  const Double_t norm=1.0/9007199254740992.0;	// 2^-53
+  Double_t u1=((Mix(key)>>11)+1)*norm;		// (0, 1]
+  Double_t u2=(Mix(key+1)>>11)*norm;		// [0, 1)
+  return TMath::Sqrt(-2.0*TMath::Log(u1))*TMath::Cos(TMath::TwoPi()*u2);
+}
+}
+
 /** --- Default constructor --------------------------------------------------- **/
 ecalDigi::ecalDigi()
   : FairTask(),
@@ -21,7 +40,9 @@ ecalDigi::ecalDigi()
     fADCMax(16384),
     fADCNoise(1.0e-3),
     fADCChannel(1.0e-3),
-    fStr(NULL), fChannelMap()
+    fStr(NULL), fChannelMap(),
+    fZeroSuppression(kFALSE), fSeed(0), fEv(0),
+    fChannelStr(NULL), fCellADCChannel(), fDigiCells(), fDigiIndex(), fNoise()
 {
   fChannelMap.clear();
 }
@@ -33,7 +54,9 @@ ecalDigi::ecalDigi(const char* name, Int_t iVerbose)
     fADCMax(16384),
     fADCChannel(1.0e-3),
     fADCNoise(1.0e-3),
-    fStr(NULL), fChannelMap()
+    fStr(NULL), fChannelMap(),
+    fZeroSuppression(kFALSE), fSeed(0), fEv(0),
+    fChannelStr(NULL), fCellADCChannel(), fDigiCells(), fDigiIndex(), fNoise()
 {
   fChannelMap.clear();
 }
@@ -78,6 +101,8 @@ InitStatus ecalDigi::Init()
     Fatal("Init()", "Can't find calorimeter structure in the system.");
     return kFATAL;
   }
+  fChannelStr=NULL;
+  fEv=0;
 
   return kSUCCESS;
 }
@@ -85,37 +110,84 @@ InitStatus ecalDigi::Init()
 void ecalDigi::InitPython(ecalStructure* structure)
 {
   fStr=structure;
+  fChannelStr=NULL;
+  fEv=0;
 }
 
-/** --- Executed task --------------------------------------------------------- **/
-void ecalDigi::Exec(Option_t* option)
+/** --- ADC channel of every cell by dense cell index ------------------------ **/
+void ecalDigi::BuildChannelArrays()
 {
+  Int_t n=fStr->GetNCellIndices();
+  Int_t i;
   ecalCell* cell;
-  list<ecalCell*> cells;
-  fStr->GetCells(cells);
-  list<ecalCell*>::const_iterator p=cells.begin();
-  Short_t adc;
+  map<Int_t, Float_t>::const_iterator p;
 
-  for(;p!=cells.end();++p)
+  fCellADCChannel.assign(n, fADCChannel);
+  if (!fChannelMap.empty())
+  for(i=0;i<n;i++)
   {
-    cell=(*p);
-    if (fChannelMap.empty())
-      adc=(Short_t)(gRandom->Gaus(cell->GetEnergy(), fADCNoise)/fADCChannel+fPedestal);
-    else
-    if (fChannelMap.find(cell->GetCellNumber())==fChannelMap.end())
+    cell=fStr->GetCellByIndex(i);
+    if (!cell) continue;
+    p=fChannelMap.find(cell->GetCellNumber());
+    if (p==fChannelMap.end())
     {
-      Error("Exec", "Channel %d not found in map. Using default value!", cell->GetCellNumber());
+      Error("BuildChannelArrays", "Channel %d not found in map. Using default value!", cell->GetCellNumber());
       //TODO: Should we insert Fatal here?
-      adc=(Short_t)(gRandom->Gaus(cell->GetEnergy(), fADCNoise)/fADCChannel+fPedestal);
-    }
-    else
-    {
-      adc=(Short_t)(gRandom->Gaus(cell->GetEnergy(), fADCNoise)/fChannelMap[cell->GetCellNumber()]+fPedestal);
+      continue;
     }
+    fCellADCChannel[i]=p->second;
+  }
+  fChannelStr=fStr;
+}
+
+/** --- Executed task --------------------------------------------------------- **/
+void ecalDigi::Exec(Option_t* option)
+{
+  if (fChannelStr!=fStr) BuildChannelArrays();
+
+  ecalCell* cell;
+  Int_t index;
+  Int_t k;
+  Int_t n;
+  Short_t adc;
+
+  /** Cells to digitize: all, or with zero suppression the ones with energy **/
+  fDigiCells.clear();
+  fDigiIndex.clear();
+  if (fZeroSuppression)
+  {
+    const vector<ecalCell*>& active=fStr->GetActiveCells();
+    for(k=0;k<(Int_t)active.size();k++)
+      if (active[k]->GetEnergy()!=0) fDigiCells.push_back(active[k]);
+  }
+  else
+  {
+    /** every cell gets noise and an ADC, so the next reset of the structure is a full one **/
+    fStr->SetAllTouched();
+    fDigiCells=fStr->GetCellArray();
+  }
+  n=fDigiCells.size();
+  fDigiIndex.resize(n);
+  for(k=0;k<n;k++)
+    fDigiIndex[k]=fStr->GetCellIndex(fDigiCells[k]->GetCellNumber());
+
+  /** Noise of all cells in one go, keyed by seed, event and cell **/
+  ULong64_t key=Mix(Mix(fSeed)+(ULong64_t)fEv);
+  fNoise.resize(n);
+  for(k=0;k<n;k++)
+    fNoise[k]=CounterGaus(key+2*(ULong64_t)fDigiIndex[k]);
+
+  for(k=0;k<n;k++)
+  {
+    cell=fDigiCells[k];
+    index=fDigiIndex[k];
+    Float_t channel=index<0?fADCChannel:fCellADCChannel[index];
+    adc=(Short_t)((cell->GetEnergy()+fADCNoise*fNoise[k])/channel+fPedestal);
     if (adc>fADCMax) adc=fADCMax;
     cell->SetEnergy(-1111);
     cell->SetADC(adc);
   }
+  fEv++;
 }
 
 /** --- Finish task ----------------------------------------------------------- **/
@@ -7,8 +7,10 @@
 #include "FairTask.h"
 
 #include <map>
+#include <vector>
 
 class ecalStructure;
+class ecalCell;
 
 class ecalDigi : public FairTask
 {
@@ -31,10 +33,15 @@ public:
   void SetPedestal(Short_t ped=80) {fPedestal=ped;}
   void SetADCMax(Short_t adcmax=16384) {fADCMax=adcmax;}
   void SetADCNoise(Float_t adcnoise=1.0e-3) {fADCNoise=adcnoise;}
-  void SetADCChannel(Float_t adcchannel=1.0e-3) {fADCChannel=adcchannel;}
+  void SetADCChannel(Float_t adcchannel=1.0e-3) {fADCChannel=adcchannel; fChannelStr=NULL;}
+  //Digitize only cells with energy. Other cells keep ADC -1111.
+  void SetZeroSuppression(Bool_t zs=kTRUE) {fZeroSuppression=zs;}
+  //Noise of a cell depends only on seed, event number and cell
+  void SetSeed(UInt_t seed=0) {fSeed=seed;}
+  void SetEventNumber(Int_t ev) {fEv=ev;}
 
   //Map: channel number -> ADC channel in GeV
-  void SetChannelMap(std::map<Int_t, Float_t> map) {fChannelMap=map;}
+  void SetChannelMap(std::map<Int_t, Float_t> map) {fChannelMap=map; fChannelStr=NULL;}
   //TODO: An ugly way, need database here
   void LoadChannelMap(const char* filename);
 
@@ -42,7 +49,12 @@ public:
   Short_t GetADCMax() const {return fADCMax;}
   Float_t GetADCNoise() const {return fADCNoise;}
   Float_t GetADCChannel() const {return fADCChannel;}
+  Bool_t GetZeroSuppression() const {return fZeroSuppression;}
+  UInt_t GetSeed() const {return fSeed;}
 private:
+  // ADC channel of every cell by dense cell index
+  void BuildChannelArrays();
+
   // Pedestal
   Short_t fPedestal;
   // ADC maximum
@@ -56,11 +68,26 @@ private:
 
   // May be better use Float_t*?
   std::map<Int_t, Float_t> fChannelMap;	//! Map: channel number -> ADC channel in GeV
+  // Digitize only cells with energy
+  Bool_t fZeroSuppression;
+  // Seed of the noise
+  UInt_t fSeed;
+  // Event number
+  Int_t fEv;
+
+  // Structure the channel arrays are built for
+  ecalStructure* fChannelStr;		//!
+  // Dense cell index -> ADC channel in GeV
+  std::vector<Float_t> fCellADCChannel;	//!
+  // Cells to digitize in this event, their dense indices and noise
+  std::vector<ecalCell*> fDigiCells;	//!
+  std::vector<Int_t> fDigiIndex;	//!
+  std::vector<Double_t> fNoise;		//!
 
   ecalDigi(const ecalDigi&);
   ecalDigi& operator=(const ecalDigi&);
 
-  ClassDef(ecalDigi, 1);
+  ClassDef(ecalDigi, 2);
 };
 
 #endif
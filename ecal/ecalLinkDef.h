@@ -13,6 +13,7 @@
 #pragma link C++ class ecalModule;
 #pragma link C++ class ecalInf+;
 #pragma link C++ class ecalStructure;
+#pragma link C++ struct ecalTrackDeposit;
 #pragma link C++ class ecalStructureFiller;
 #pragma link C++ class ecalDigi;
 #pragma link C++ class ecalPrepare;
@@ -36,6 +36,8 @@ void ecalMatch::Exec(Option_t* option,TClonesArray* reconstructed,TClonesArray*
   Int_t trn;
   Float_t max;
 //  if (fVerbose>0) Info("Exec", "Event %d.", fEv);
+  /** Track information of the cells, if the filler kept it in the flat buffer **/
+  fStr->FillTrackMaps();
   for(i=0;i<n;i++)
   {
     rc=(ecalReconstructed*)fReconstucted->At(i);
@@ -10,6 +10,7 @@
 #include "TClonesArray.h"
 
 #include <list>
+#include <vector>
 #include <iostream>
 
 using namespace std;
@@ -72,9 +73,9 @@ void ecalMaximumLocator::Finish()
 
 void ecalMaximumLocator::Exec(const Option_t* opt)
 {
-  list<ecalCell*> all;
+  vector<ecalCell*> all;
   list<ecalCell*> cells;
-  list<ecalCell*>::const_iterator p;
+  vector<ecalCell*>::const_iterator p;
   list<ecalCell*>::const_iterator r;
   Double_t e;
   Double_t z=fStr->GetEcalInf()->GetZPos();
@@ -85,7 +86,11 @@ void ecalMaximumLocator::Exec(const Option_t* opt)
 
   fEvent++;
   fMaximums->Clear();
-  fStr->GetCells(all);
+  /** the other cells are reset, their zero energy is below a positive cut **/
+  if (fECut>0)
+    fStr->GetTouchedCells(all);
+  else
+    all=fStr->GetCellArray();
   for(p=all.begin();p!=all.end();++p)
   {
     e=(*p)->GetEnergy();
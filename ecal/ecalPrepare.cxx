@@ -10,6 +10,7 @@
 #include <iostream>
 #include <fstream>
 #include <list>
+#include <vector>
 
 using namespace std;
 
@@ -88,15 +89,18 @@ void ecalPrepare::InitPython(ecalStructure* structure)
 void ecalPrepare::Exec(Option_t* option)
 {
   ecalCell* cell;
-  list<ecalCell*> cells;
-  fStr->GetCells(cells);
-  list<ecalCell*>::const_iterator p=cells.begin();
+  /** the other cells are reset and not digitized **/
+  vector<ecalCell*> cells;
+  fStr->GetTouchedCells(cells);
+  vector<ecalCell*>::const_iterator p=cells.begin();
   Short_t adc;
 
   for(;p!=cells.end();++p)
   {
     cell=(*p);
     adc=cell->GetADC();
+    /** Not digitized, zero suppressed by ecalDigi **/
+    if (adc==-1111) continue;
     adc-=fPedestal; //if (adc<0) adc=0;
     if (fChannelMap.empty())
       cell->SetEnergy(adc*fADCChannel);
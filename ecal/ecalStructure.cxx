@@ -20,43 +20,157 @@ using namespace std;
 
 ecalCell* ecalStructure::GetCell(Int_t volId, Int_t& ten)
 {
-  UInt_t i;
-  static Int_t volidmax = 0;
-  volidmax=10000000;
-
-  if ((Int_t)fHash.size()<volidmax)
-  {
-    fHash.resize(volidmax);
-    for(i=0;i<fHash.size();i++)
-      fHash[i]=NULL;
-  }
-  if (volId>volidmax)
-    return NULL;
-  if (fHash[volId]==NULL)
+  /** volume id is (my*100+mx)*100+cell+1, cached per module and cell **/
+  Int_t cell=volId%100-1;
+  Int_t mnum=(volId>=0&&cell>=0&&cell<fCellsPerModule)?GetNumber((volId/100)%100, volId/10000):-1;
+  __ecalCellWrapper tmp;
+  __ecalCellWrapper* w=(mnum==-1)?&tmp:&fVolCells[mnum*fCellsPerModule+cell];
+  if (mnum==-1||!w->resolved)
   {
     Bool_t lisPS;
     Int_t iten;
     Float_t x;
     Float_t y;
-    fHash[volId]=new __ecalCellWrapper();
     lisPS=ecal::GetCellCoordInf(volId, x, y, iten);
-    fHash[volId]->cell=GetCell(x+0.025,y+0.025);
-    fHash[volId]->isPsTen=iten*2;
-    if (lisPS) fHash[volId]->isPsTen+=1;
+    w->cell=GetCell(x+0.025,y+0.025);
+    w->isPsTen=iten*2;
+    if (lisPS) w->isPsTen+=1;
+    w->resolved=kTRUE;
   }
-  ten=fHash[volId]->isPsTen/2;
-  return fHash[volId]->cell;
+  ten=w->isPsTen/2;
+  if (w->cell) SetActive(w->cell);
+  return w->cell;
+}
+
+//-----------------------------------------------------------------------------
+Int_t ecalStructure::GetIndex(Int_t mnum, Int_t cx, Int_t cy) const
+{
+  if (mnum<0||mnum>=(Int_t)fStructure.size()||fStructure[mnum]==NULL) return -1;
+  Int_t type=fStructure[mnum]->GetType();
+  if (cx<0||cy<0||cx>=type||cy>=type) return -1;
+  return mnum*fCellsPerModule+cy*type+cx;
+}
+
+//-----------------------------------------------------------------------------
+Int_t ecalStructure::GetCellIndex(Int_t cellnumber) const
+{
+  /** cell number is ((mx*100+my)*10+cy+1)*10+cx+1 **/
+  Int_t mnum=cellnumber/100;
+  Int_t cellnum=cellnumber%100;
+  return GetIndex(GetNumber(mnum/100, mnum%100), cellnum%10-1, cellnum/10-1);
+}
+
+//-----------------------------------------------------------------------------
+void ecalStructure::SetActive(ecalCell* cell)
+{
+  Int_t index=GetCellIndex(cell->GetCellNumber());
+  if (index<0||fIsActive[index]) return;
+  fIsActive[index]=1;
+  fActive.push_back(cell);
+  fActiveIndex.push_back(index);
 }
 
 //-----------------------------------------------------------------------------
 void ecalStructure::Serialize()
 {
   fCells.clear();
+  fCellsPerModule=1;
   for(UInt_t i=0;i<fStructure.size();i++)
   if (fStructure[i])
   {
     vector<ecalCell*> cells=fStructure[i]->GetCells();
     copy(cells.begin(),cells.end(), back_inserter(fCells));
+    fCellsPerModule=TMath::Max(fCellsPerModule, (Int_t)cells.size());
+  }
+  fCellByIndex.assign(fStructure.size()*fCellsPerModule, NULL);
+  for(UInt_t i=0;i<fStructure.size();i++)
+  if (fStructure[i])
+  {
+    Int_t type=fStructure[i]->GetType();
+    for(Int_t cy=0;cy<type;cy++)
+    for(Int_t cx=0;cx<type;cx++)
+      fCellByIndex[GetIndex(i, cx, cy)]=fStructure[i]->At(cx, cy);
+  }
+  fSerial.assign(fCellByIndex.size(), -1);
+  for(UInt_t k=0;k<fCells.size();k++)
+  {
+    Int_t index=GetCellIndex(fCells[k]->GetCellNumber());
+    if (index>=0) fSerial[index]=k;
+  }
+  __ecalCellWrapper unresolved={NULL, 0, kFALSE};
+  fVolCells.assign(fCellByIndex.size(), unresolved);
+  fIsActive.assign(fCellByIndex.size(), 0);
+  fActive.clear();
+  fActiveIndex.clear();
+  fDeposits.clear();
+  fDepositsMerged=kTRUE;
+  fTrackMapsFilled=kFALSE;
+}
+
+//-----------------------------------------------------------------------------
+void ecalStructure::GetTouchedCells(vector<ecalCell*>& cells) const
+{
+  if (fAllTouched)
+  {
+    cells=fCells;
+    return;
+  }
+  vector<Int_t> serial(fActiveIndex.size());
+  for(UInt_t i=0;i<fActiveIndex.size();i++)
+    serial[i]=fSerial[fActiveIndex[i]];
+  sort(serial.begin(), serial.end());
+  cells.resize(serial.size());
+  for(UInt_t i=0;i<serial.size();i++)
+    cells[i]=fCells[serial[i]];
+}
+
+//-----------------------------------------------------------------------------
+static Bool_t _deposit_less(const ecalTrackDeposit& a, const ecalTrackDeposit& b)
+{
+  return a.fCell<b.fCell||(a.fCell==b.fCell&&a.fTrack<b.fTrack);
+}
+
+//-----------------------------------------------------------------------------
+const vector<ecalTrackDeposit>& ecalStructure::GetTrackDeposits()
+{
+  /** sum in the order of the points, time is the earliest one
+   ** except -1111 (no time), as ecalCellMC::AddTrackEnergy does **/
+  if (fDepositsMerged) return fDeposits;
+  stable_sort(fDeposits.begin(), fDeposits.end(), _deposit_less);
+  UInt_t n=0;
+  for(UInt_t i=0;i<fDeposits.size();i++)
+  {
+    const ecalTrackDeposit& d=fDeposits[i];
+    if (n>0&&fDeposits[n-1].fCell==d.fCell&&fDeposits[n-1].fTrack==d.fTrack)
+    {
+      ecalTrackDeposit& m=fDeposits[n-1];
+      m.fEnergy+=d.fEnergy;
+      if (d.fTime!=-1111&&(m.fTime==-1111||m.fTime>d.fTime)) m.fTime=d.fTime;
+      continue;
+    }
+    fDeposits[n++]=d;
+  }
+  fDeposits.resize(n);
+  fDepositsMerged=kTRUE;
+  return fDeposits;
+}
+
+//-----------------------------------------------------------------------------
+void ecalStructure::FillTrackMaps()
+{
+  if (fTrackMapsFilled) return;
+  fTrackMapsFilled=kTRUE;
+  if (fUseMC==0)
+  {
+    if (!fDeposits.empty())
+      Error("FillTrackMaps", "Track deposits without MC cells.");
+    return;
+  }
+  GetTrackDeposits();
+  for(UInt_t i=0;i<fDeposits.size();i++)
+  {
+    const ecalTrackDeposit& d=fDeposits[i];
+    ((ecalCellMC*)fCellByIndex[d.fCell])->AddTrackEnergy(d.fTrack, d.fEnergy, d.fTime);
   }
 }
 
@@ -75,7 +189,16 @@ ecalStructure::ecalStructure(ecalInf* ecalinf)
     fEcalInf(ecalinf),
     fStructure(),
     fCells(),
-    fHash()
+    fCellsPerModule(1),
+    fCellByIndex(),
+    fVolCells(),
+    fActive(),
+    fActiveIndex(),
+    fIsActive(),
+    fAllTouched(kFALSE),
+    fDeposits(),
+    fDepositsMerged(kTRUE),
+    fTrackMapsFilled(kFALSE)
 {
   fX1=fEcalInf->GetXPos()-\
     fEcalInf->GetModuleSize()*fEcalInf->GetXSize()/2.0;
@@ -307,19 +430,37 @@ void ecalStructure::CreateNLists(ecalCell* cell)
 }
 
 //-----------------------------------------------------------------------------
-void ecalStructure::ResetModules()
+void ecalStructure::ResetCell(ecalCell* cell)
 {
-  list<ecalCell*>::const_iterator p=fCells.begin();
   if (fUseMC==0)
+    cell->ResetEnergyFast();
+  else
+    ((ecalCellMC*)cell)->ResetEnergy();
+}
+
+//-----------------------------------------------------------------------------
+void ecalStructure::ResetModules()
+{
+  /** only the active cells can have changed, unless all cells were handed out **/
+  if (fAllTouched)
   {
-    for(;p!=fCells.end();++p)
-      (*p)->ResetEnergyFast();
+    for(UInt_t i=0;i<fCells.size();i++)
+      ResetCell(fCells[i]);
+    fAllTouched=kFALSE;
   }
   else
   {
-    for(;p!=fCells.end();++p)
-    ((ecalCellMC*)(*p))->ResetEnergy();
+    for(UInt_t i=0;i<fActive.size();i++)
+      ResetCell(fActive[i]);
   }
+  for(UInt_t i=0;i<fActiveIndex.size();i++)
+    fIsActive[fActiveIndex[i]]=0;
+  fActive.clear();
+  fActiveIndex.clear();
+  // the cell track maps are empty again, the next event fills them anew
+  fDeposits.clear();
+  fDepositsMerged=kTRUE;
+  fTrackMapsFilled=kFALSE;
 }
 
 //-----------------------------------------------------------------------------
@@ -19,7 +19,22 @@
 
 #define _DECALSTRUCT
 
-struct __ecalCellWrapper;
+struct __ecalCellWrapper
+{
+public:
+  ecalCell* cell;
+  Char_t isPsTen;
+  Bool_t resolved;
+};
+
+/** Energy deposition of a track in a cell, cell is the dense cell index **/
+struct ecalTrackDeposit
+{
+  Int_t fCell;
+  Int_t fTrack;
+  Float_t fEnergy;
+  Float_t fTime;
+};
 
 class ecalStructure : public TNamed
 {
@@ -42,11 +57,44 @@ public:
   Float_t GetY2() const;
   inline ecalInf* GetEcalInf() const {return fEcalInf;}
   inline void GetStructure(std::vector<ecalModule*>& stru) const {stru=fStructure;}
-  inline void GetCells(std::list<ecalCell*>& cells) const {cells=fCells;}
+  /** All cells. The caller may change any of them, so the next reset is a full one **/
+  inline void GetCells(std::list<ecalCell*>& cells) const {cells.assign(fCells.begin(), fCells.end()); fAllTouched=kTRUE;}
+  /** All cells in module order, read only use **/
+  inline const std::vector<ecalCell*>& GetCellArray() const {return fCells;}
+  /** Cells given energy (through GetCell(volId, ten) or AddEnergy) since the last reset **/
+  inline const std::vector<ecalCell*>& GetActiveCells() const {return fActive;}
+  /** Cells that can differ from their reset state, in the order of GetCellArray:
+   ** all cells after GetCells or SetAllTouched, otherwise the active cells **/
+  void GetTouchedCells(std::vector<ecalCell*>& cells) const;
+  /** The caller changes all cells, the next reset is a full one **/
+  inline void SetAllTouched() {fAllTouched=kTRUE;}
+  inline Bool_t IsAllTouched() const {return fAllTouched;}
+  /** Dense index (module, row, column) of a cell number, -1 if there is no such cell **/
+  Int_t GetCellIndex(Int_t cellnumber) const;
+  /** Cell with given dense index **/
+  inline ecalCell* GetCellByIndex(Int_t index) const {return fCellByIndex[index];}
+  inline Int_t GetNCellIndices() const {return fCellByIndex.size();}
+  /** Add the cell to the active cells **/
+  void SetActive(ecalCell* cell);
   //Create neighbors lists
   void CreateNLists(ecalCell* cell);
+  /** Reset the active cells, or all cells after GetCells or SetAllTouched.
+   ** ecalDigi without zero suppression writes every cell, so only a zero
+   ** suppressed chain keeps the reset to the active cells **/
   void ResetModules();
 
+  /** Track information kept in a flat buffer instead of the ecalCellMC maps **/
+  inline void AddTrackDeposit(Int_t index, Int_t track, Float_t energy, Float_t time)
+  {
+    ecalTrackDeposit d={index, track, energy, time};
+    fDeposits.push_back(d);
+    fDepositsMerged=kFALSE;
+  }
+  /** Deposits summed per (cell, track), sorted by dense cell index and track **/
+  const std::vector<ecalTrackDeposit>& GetTrackDeposits();
+  /** Fill the ecalCellMC track maps from the buffer, once per event **/
+  void FillTrackMaps();
+
   ecalModule* CreateModule(char type, Int_t number, Float_t x1, Float_t y1, Float_t x2, Float_t y2);
   //Some usefull procedures for hit processing
 
@@ -67,9 +115,12 @@ public:
 
 private:
   Int_t GetNum(Int_t x, Int_t y) const;
+  /** Dense index of a module number and cell (column, row) in it, -1 if outside **/
+  Int_t GetIndex(Int_t mnum, Int_t cx, Int_t cy) const;
+  void ResetCell(ecalCell* cell);
 
 private:
-  /** Creates fCells lists **/
+  /** Creates fCells lists and the dense cell index **/
   void Serialize();
   /** Use store MC information in cells **/
   Int_t fUseMC;
@@ -82,14 +133,30 @@ private:
   /** total list of ECAL modules **/
   std::vector<ecalModule*> fStructure;
   /** All ECAL cells **/
-  std::list<ecalCell*> fCells;
-  /** MCPoint id -> ECAL cell**/
-  std::vector<__ecalCellWrapper*> fHash;
+  std::vector<ecalCell*> fCells;	//!
+  /** Cells per module in the dense index, square of the largest module type **/
+  Int_t fCellsPerModule;
+  /** module number * fCellsPerModule + row * type + column -> cell **/
+  std::vector<ecalCell*> fCellByIndex;	//!
+  /** dense index -> position in fCells **/
+  std::vector<Int_t> fSerial;	//!
+  /** dense index of the MCPoint volume id -> ECAL cell, resolved on first use **/
+  std::vector<__ecalCellWrapper> fVolCells;	//!
+  /** Cells given energy in this event, their dense index and flag **/
+  std::vector<ecalCell*> fActive;	//!
+  std::vector<Int_t> fActiveIndex;	//!
+  std::vector<Char_t> fIsActive;	//!
+  /** All cells were handed out, reset all of them **/
+  mutable Bool_t fAllTouched;	//!
+  /** Track deposits of the event, reused between events **/
+  std::vector<ecalTrackDeposit> fDeposits;	//!
+  Bool_t fDepositsMerged;	//!
+  Bool_t fTrackMapsFilled;	//!
 
   ecalStructure(const ecalStructure&);
   ecalStructure& operator=(const ecalStructure&);
 
-  ClassDef(ecalStructure,1);
+  ClassDef(ecalStructure,2);
 };
 
 inline ecalCell* ecalStructure::GetCell(Float_t x, Float_t y) const
@@ -152,6 +219,7 @@ inline Bool_t ecalStructure::AddEnergy(Float_t x, Float_t y, Float_t energy)
   if (cell)
   {
 	  cell->AddEnergy(energy);
+	  SetActive(cell);
   }
   else
     return kFALSE;
@@ -178,11 +246,5 @@ inline Int_t ecalStructure::GetHitId(Float_t x, Float_t y) const
     return -1111;
 }
 
-struct __ecalCellWrapper
-{
-public:
-  ecalCell* cell;
-  Char_t isPsTen;
-};
 
 #endif
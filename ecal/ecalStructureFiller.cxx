@@ -25,6 +25,7 @@ ecalStructureFiller::ecalStructureFiller()
     fInited(kFALSE),
     fUseMCPoints(kFALSE),
     fStoreTrackInfo(kTRUE),
+    fUseTrackBuffer(kFALSE),
     fFileGeo("")
 {
 }
@@ -40,6 +41,7 @@ ecalStructureFiller::ecalStructureFiller(const char *name, const Int_t iVerbose,
     fInited(kFALSE),
     fUseMCPoints(kFALSE),
     fStoreTrackInfo(kTRUE),
+    fUseTrackBuffer(kFALSE),
     fFileGeo(fileGeo)
 {
 }
@@ -97,7 +99,10 @@ ecalStructure* ecalStructureFiller::InitPython(TClonesArray* litePoints)
 }
 
 
-/** Loop over MCPoints hits and add them to cells **/
+/** Loop over MCPoints hits and add them to cells.
+ ** One pass: the cell energy and the track information are filled together,
+ ** the track information either to the ecalCellMC maps or to the flat
+ ** buffer of the structure. **/
 void ecalStructureFiller::LoopForMCPoints()
 {
   ecalPoint* pt;
@@ -116,18 +121,13 @@ void ecalStructureFiller::LoopForMCPoints()
   {
     pt=(ecalPoint*)fListECALpts->At(j);
     cell=fStr->GetCell(pt->GetDetectorID(), ten);
-    if (ten==0) {
-	cell->AddEnergy(pt->GetEnergyLoss());
-    }
-  }
-  if (fStoreTrackInfo)
-  for(UInt_t j=0; j<n; j++)
-  {
-    pt=(ecalPoint*)fListECALpts->At(j);
-    ecalCellMC* cellmc=(ecalCellMC*)fStr->GetCell(pt->GetDetectorID(), ten);
-    if (ten==0) {
-        cellmc->AddTrackEnergy(pt->GetTrackID(),pt->GetEnergyLoss(), pt->GetTime());
-    }
+    if (ten!=0) continue;
+    cell->AddEnergy(pt->GetEnergyLoss());
+    if (!fStoreTrackInfo) continue;
+    if (fUseTrackBuffer)
+      fStr->AddTrackDeposit(fStr->GetCellIndex(cell->GetCellNumber()), pt->GetTrackID(), pt->GetEnergyLoss(), pt->GetTime());
+    else
+      ((ecalCellMC*)cell)->AddTrackEnergy(pt->GetTrackID(),pt->GetEnergyLoss(), pt->GetTime());
   }
 }
 
@@ -52,6 +52,10 @@ public:
   ecalStructure* GetStructure() const;
   void StoreTrackInformation(Bool_t storetrackinfo=kTRUE);
   Bool_t GetStoreTrackInformation() const;
+  /** Keep the track information in the flat buffer of the structure.
+   ** The ecalCellMC maps are filled by ecalStructure::FillTrackMaps() **/
+  void UseTrackBuffer(Bool_t usebuffer=kTRUE) {fUseTrackBuffer=usebuffer;}
+  Bool_t GetUseTrackBuffer() const {return fUseTrackBuffer;}
 
   Bool_t GetUseMCPoints() const;
   Bool_t GetUseSummableHits() const;
@@ -76,13 +80,15 @@ private:
 
   /** Should we store information about tracks/energy depostion **/
   Bool_t fStoreTrackInfo;
+  /** Should we store the track information in the flat buffer **/
+  Bool_t fUseTrackBuffer;
   /** Geo file to use **/
   TString fFileGeo;
 
   ecalStructureFiller(const ecalStructureFiller&);
   ecalStructureFiller& operator=(const ecalStructureFiller&);
 
-  ClassDef(ecalStructureFiller,1)
+  ClassDef(ecalStructureFiller,2)
 
 };
 
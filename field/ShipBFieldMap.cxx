@@ -5,12 +5,14 @@
 */
 
 #include "ShipBFieldMap.h"
+#include "ShipBFieldMapSoA.h"
 
 #include "TFile.h"
 #include "TTree.h"
 
 #include "FairLogger.h"   /// for FairLogger, MESSAGE_ORIGIN
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -23,9 +25,12 @@ ShipBFieldMap::ShipBFieldMap(const std::string& label,
 			     Float_t theta,
 			     Float_t psi,
 			     Float_t scale,
-			     Bool_t isSymmetric) :
+			     Bool_t isSymmetric,
+			     InterpolationMode mode) :
     TVirtualMagField(label.c_str()),
-    fieldMap_(new floatArray()),
+    fieldMap_(std::make_shared<floatArray>()),
+    soaMap_(),
+    mode_(mode),
     mapFileName_(mapFileName),
     initialised_(kFALSE),
     isCopy_(kFALSE),
@@ -52,11 +57,8 @@ ShipBFieldMap::ShipBFieldMap(const std::string& label,
 
 ShipBFieldMap::~ShipBFieldMap()
 {
-    // Delete the internal vector storing the field map values
-    if (fieldMap_ && isCopy_ == kFALSE) {
-	delete fieldMap_; fieldMap_ = 0;
-    }
-
+    // The field map data is shared with any copies, and is deleted
+    // automatically when the last map using it is destroyed
     if (theTrans_) {delete theTrans_; theTrans_ = 0;}
 
 }
@@ -67,6 +69,8 @@ ShipBFieldMap::ShipBFieldMap(const std::string& newName, const ShipBFieldMap& rh
 			     Float_t newPhi, Float_t newTheta, Float_t newPsi, Float_t newScale) :
     TVirtualMagField(newName.c_str()),
     fieldMap_(rhs.fieldMap_),
+    soaMap_(rhs.soaMap_),
+    mode_(rhs.mode_),
     mapFileName_(rhs.GetMapFileName()),
     initialised_(kFALSE),
     isCopy_(kTRUE),
@@ -97,15 +101,22 @@ ShipBFieldMap::ShipBFieldMap(const std::string& newName, const ShipBFieldMap& rh
     theTrans_(0),
     Tesla_(10.0)
 {
-    // Copy constructor with new label and different global offset, which uses
-    // the same field map data (pointer) and distance units as the rhs object
+    // Copy constructor with new label and different global offset, which shares
+    // the same (read-only) field map data and distance units as the rhs object
     this->initialise();
 }
 
 void ShipBFieldMap::Field(const Double_t* position, Double_t* B)
+{
+    this->GetFieldValue(position, B);
+}
+
+void ShipBFieldMap::GetFieldValue(const Double_t* position, Double_t* B) const
 {
 
-    // Set the B field components given the global position coordinates
+    // Set the B field components given the global position coordinates.
+    // This must not modify any data members, since it can be called
+    // concurrently from several threads
 
     // Convert the global position into a local one for the volume field.
     // Initialise the local co-ords, which will get overwritten if the
@@ -159,6 +170,19 @@ void ShipBFieldMap::Field(const Double_t* position, Double_t* B)
     Bool_t inside = this->insideRange(x, y, z);
     if (inside == kFALSE) {return;}
 
+    if (soaMap_) {
+
+	// Gather all corners and interpolate the three components together
+	Float_t BLocal[3] = {0.0, 0.0, 0.0};
+	if (soaMap_->interpolate(x, y, z, BLocal)) {
+	    B[0] = BLocal[0]*scale_*BxSign;
+	    B[1] = BLocal[1]*scale_;
+	    B[2] = BLocal[2]*scale_*BzSign;
+	}
+	return;
+
+    }
+
     // Find the neighbouring bins for the given point
     binPair xBinInfo = this->getBinInfo(x, ShipBFieldMap::xAxis);
     binPair yBinInfo = this->getBinInfo(y, ShipBFieldMap::yAxis);
@@ -176,30 +200,32 @@ void ShipBFieldMap::Field(const Double_t* position, Double_t* B)
     Int_t iY1(iY + 1);
     Int_t iZ1(iZ + 1);
 
-    binA_ = this->getMapBin(iX, iY, iZ);
-    binB_ = this->getMapBin(iX1, iY, iZ);
-    binC_ = this->getMapBin(iX, iY1, iZ);
-    binD_ = this->getMapBin(iX1, iY1, iZ);
-    binE_ = this->getMapBin(iX, iY, iZ1);
-    binF_ = this->getMapBin(iX1, iY, iZ1);
-    binG_ = this->getMapBin(iX, iY1, iZ1);
-    binH_ = this->getMapBin(iX1, iY1, iZ1);
+    interpInfo info;
+
+    info.bins_[0] = this->getMapBin(iX, iY, iZ);
+    info.bins_[1] = this->getMapBin(iX1, iY, iZ);
+    info.bins_[2] = this->getMapBin(iX, iY1, iZ);
+    info.bins_[3] = this->getMapBin(iX1, iY1, iZ);
+    info.bins_[4] = this->getMapBin(iX, iY, iZ1);
+    info.bins_[5] = this->getMapBin(iX1, iY, iZ1);
+    info.bins_[6] = this->getMapBin(iX, iY1, iZ1);
+    info.bins_[7] = this->getMapBin(iX1, iY1, iZ1);
 
     // Retrieve the fractional bin distances
-    xFrac_ = xBinInfo.second;
-    yFrac_ = yBinInfo.second;
-    zFrac_ = zBinInfo.second;
+    info.xFrac_ = xBinInfo.second;
+    info.yFrac_ = yBinInfo.second;
+    info.zFrac_ = zBinInfo.second;
 
     // Set the complimentary fractional bin distances
-    xFrac1_ = 1.0 - xFrac_;
-    yFrac1_ = 1.0 - yFrac_;
-    zFrac1_ = 1.0 - zFrac_;
+    info.xFrac1_ = 1.0 - info.xFrac_;
+    info.yFrac1_ = 1.0 - info.yFrac_;
+    info.zFrac1_ = 1.0 - info.zFrac_;
 
     // Finally get the magnetic field components using trilinear interpolation
     // and scale with the appropriate multiplication factor (default = 1.0)
-    B[0] = this->BInterCalc(ShipBFieldMap::xAxis)*scale_*BxSign;
-    B[1] = this->BInterCalc(ShipBFieldMap::yAxis)*scale_;
-    B[2] = this->BInterCalc(ShipBFieldMap::zAxis) * scale_ * BzSign;
+    B[0] = this->BInterCalc(ShipBFieldMap::xAxis, info)*scale_*BxSign;
+    B[1] = this->BInterCalc(ShipBFieldMap::yAxis, info)*scale_;
+    B[2] = this->BInterCalc(ShipBFieldMap::zAxis, info)*scale_*BzSign;
 
 }
 
@@ -237,11 +263,15 @@ void ShipBFieldMap::readMapFile()
     LOG(INFO) << "ShipBFieldMap::readMapFile() creating field " << this->GetName()
 	     << " using file " << mapFileName_;
 
-    // Check to see if we have a ROOT file
+    // Check to see if we have a ROOT or binary file
     if (mapFileName_.find(".root") != std::string::npos) {
 
 	this->readRootFile();
 
+    } else if (mapFileName_.find(".bmap") != std::string::npos) {
+
+	this->readBinaryFile();
+
     } else {
 
 	this->readTextFile();
@@ -310,7 +340,7 @@ void ShipBFieldMap::readRootFile() {
 	    nEntries = 0;
 	}
 
-	fieldMap_->reserve(nEntries);
+	this->initStorage();
 
 	for (Int_t i = 0; i < nEntries; i++) {
 
@@ -323,9 +353,7 @@ void ShipBFieldMap::readRootFile() {
 	    Bz *= Tesla_;
 
 	    // Store the B field 3-vector
-	    std::vector<Float_t> BVector(3);
-	    BVector[0] = Bx; BVector[1] = By; BVector[2] = Bz;
-	    fieldMap_->push_back(BVector);
+	    this->storeBin(i, Bx, By, Bz);
 
 	}
 
@@ -361,7 +389,7 @@ void ShipBFieldMap::readTextFile() {
 
 	// The remaining lines contain Bx,By,Bz data values
 	// in ascending z,y,x co-ord order
-	fieldMap_->reserve(N_);
+	this->initStorage();
 
 	Float_t Bx(0.0), By(0.0), Bz(0.0);
 
@@ -376,9 +404,7 @@ void ShipBFieldMap::readTextFile() {
 	    Bz *= Tesla_;
 
 	    // Store the B field 3-vector
-	    std::vector<Float_t> BVector(3);
-	    BVector[0] = Bx; BVector[1] = By; BVector[2] = Bz;
-	    fieldMap_->push_back(BVector);
+	    this->storeBin(i, Bx, By, Bz);
 
 	}
 
@@ -388,7 +414,115 @@ void ShipBFieldMap::readTextFile() {
 
 }
 
-Bool_t ShipBFieldMap::insideRange(Float_t x, Float_t y, Float_t z)
+void ShipBFieldMap::readBinaryFile() {
+
+    // The binary file is mapped read-only and its arrays are used directly as the
+    // SoA interpolation storage, so nothing is copied and the memory is shared with
+    // any other process using the same file
+    ShipBFieldMapSoA::binaryHeader header;
+    ShipBFieldMapSoA* theMap = ShipBFieldMapSoA::mapBinaryFile(mapFileName_, header);
+
+    if (!theMap) {
+	LOG(FATAL) << "ShipBFieldMap: could not use the binary field map " << mapFileName_;
+	return;
+    }
+
+    xMin_ = header.xMin_; xMax_ = header.xMax_; dx_ = header.dx_;
+    yMin_ = header.yMin_; yMax_ = header.yMax_; dy_ = header.dy_;
+    zMin_ = header.zMin_; zMax_ = header.zMax_; dz_ = header.dz_;
+
+    this->setLimits();
+
+    if (Nx_ != header.Nx_ || Ny_ != header.Ny_ || Nz_ != header.Nz_) {
+	LOG(FATAL) << "ShipBFieldMap: binning in " << mapFileName_
+		   << " is inconsistent with its coordinate limits";
+    }
+
+    if (mode_ != ShipBFieldMap::SIMD) {
+	LOG(INFO) << "ShipBFieldMap: using SIMD interpolation for the binary field map "
+		  << mapFileName_;
+	mode_ = ShipBFieldMap::SIMD;
+    }
+
+    soaMap_.reset(theMap);
+
+}
+
+Bool_t ShipBFieldMap::writeBinaryFile(const std::string& fileName) const
+{
+
+    ShipBFieldMapSoA::binaryHeader header = {};
+    header.Nx_ = Nx_; header.Ny_ = Ny_; header.Nz_ = Nz_;
+    header.xMin_ = xMin_; header.xMax_ = xMax_; header.dx_ = dx_;
+    header.yMin_ = yMin_; header.yMax_ = yMax_; header.dy_ = dy_;
+    header.zMin_ = zMin_; header.zMax_ = zMax_; header.dz_ = dz_;
+
+    Bool_t written(kFALSE);
+
+    if (soaMap_) {
+
+	written = soaMap_->writeBinaryFile(fileName, header);
+
+    } else if (fieldMap_ && fieldMap_->size() == static_cast<size_t>(N_)) {
+
+	// Rearrange the 3-vectors into the structure-of-arrays file layout
+	ShipBFieldMapSoA theMap(Nx_, Ny_, Nz_, xMin_, dx_, yMin_, dy_, zMin_, dz_);
+	for (Int_t i = 0; i < N_; i++) {
+	    const std::vector<Float_t>& BVector = (*fieldMap_)[i];
+	    theMap.setBin(i, BVector[0], BVector[1], BVector[2]);
+	}
+
+	written = theMap.writeBinaryFile(fileName, header);
+
+    } else {
+
+	LOG(ERROR) << "ShipBFieldMap: no field map data to write for " << this->GetName();
+
+    }
+
+    if (written) {
+	LOG(INFO) << "ShipBFieldMap: written binary field map " << fileName
+		  << " with " << N_ << " bins";
+    }
+
+    return written;
+
+}
+
+void ShipBFieldMap::initStorage()
+{
+
+    if (mode_ == ShipBFieldMap::SIMD) {
+
+	soaMap_ = std::make_shared<ShipBFieldMapSoA>(Nx_, Ny_, Nz_, xMin_, dx_, yMin_, dy_,
+						     zMin_, dz_);
+
+    } else {
+
+	fieldMap_->reserve(N_);
+
+    }
+
+}
+
+void ShipBFieldMap::storeBin(Int_t index, Float_t Bx, Float_t By, Float_t Bz)
+{
+
+    if (soaMap_) {
+
+	soaMap_->setBin(index, Bx, By, Bz);
+
+    } else {
+
+	std::vector<Float_t> BVector(3);
+	BVector[0] = Bx; BVector[1] = By; BVector[2] = Bz;
+	fieldMap_->push_back(BVector);
+
+    }
+
+}
+
+Bool_t ShipBFieldMap::insideRange(Float_t x, Float_t y, Float_t z) const
 {
 
     Bool_t inside(kFALSE);
@@ -400,6 +534,36 @@ Bool_t ShipBFieldMap::insideRange(Float_t x, Float_t y, Float_t z)
 
 }
 
+void ShipBFieldMap::GetGlobalBounds(Double_t* lo, Double_t* hi) const
+{
+
+    // The local validity box, mirrored in x and y for quadrant symmetry
+    Double_t localLo[3] = {xMin_, yMin_, zMin_};
+    Double_t localHi[3] = {xMax_, yMax_, zMax_};
+    if (isSymmetric_) {
+	localLo[0] = -xMax_;
+	localLo[1] = -yMax_;
+    }
+
+    // Enclose the 8 transformed corners
+    for (Int_t k = 0; k < 3; k++) {
+	lo[k] = 1e30;
+	hi[k] = -1e30;
+    }
+    for (Int_t corner = 0; corner < 8; corner++) {
+	Double_t local[3] = {(corner & 1) ? localHi[0] : localLo[0],
+			     (corner & 2) ? localHi[1] : localLo[1],
+			     (corner & 4) ? localHi[2] : localLo[2]};
+	Double_t global[3] = {local[0], local[1], local[2]};
+	if (theTrans_) {theTrans_->LocalToMaster(local, global);}
+	for (Int_t k = 0; k < 3; k++) {
+	    lo[k] = std::min(lo[k], global[k]);
+	    hi[k] = std::max(hi[k], global[k]);
+	}
+    }
+
+}
+
 void ShipBFieldMap::setLimits() {
 
     // Since the default SHIP distance unit is cm, we do not need to convert
@@ -435,7 +599,7 @@ void ShipBFieldMap::setLimits() {
 }
 
 
-ShipBFieldMap::binPair ShipBFieldMap::getBinInfo(Float_t u, ShipBFieldMap::CoordAxis theAxis)
+ShipBFieldMap::binPair ShipBFieldMap::getBinInfo(Float_t u, ShipBFieldMap::CoordAxis theAxis) const
 {
 
     Float_t du(0.0), uMin(0.0), Nu(0);
@@ -474,7 +638,7 @@ ShipBFieldMap::binPair ShipBFieldMap::getBinInfo(Float_t u, ShipBFieldMap::Coord
 
 }
 
-Int_t ShipBFieldMap::getMapBin(Int_t iX, Int_t iY, Int_t iZ)
+Int_t ShipBFieldMap::getMapBin(Int_t iX, Int_t iY, Int_t iZ) const
 {
 
     // Get the index of the map entry corresponding to the x,y,z bins.
@@ -491,11 +655,11 @@ Int_t ShipBFieldMap::getMapBin(Int_t iX, Int_t iY, Int_t iZ)
 
 }
 
-Float_t ShipBFieldMap::BInterCalc(CoordAxis theAxis)
+Float_t ShipBFieldMap::BInterCalc(CoordAxis theAxis, const interpInfo& info) const
 {
 
     // Find the magnetic field component along theAxis using trilinear
-    // interpolation based on the current position and neighbouring bins
+    // interpolation based on the point's neighbouring bins and fractions
     Float_t result(0.0);
 
     Int_t iAxis(0);
@@ -509,27 +673,28 @@ Float_t ShipBFieldMap::BInterCalc(CoordAxis theAxis)
     if (fieldMap_) {
 
 	// Get the field component values for the neighbouring bins
-	Float_t A = (*fieldMap_)[binA_][iAxis];
-	Float_t B = (*fieldMap_)[binB_][iAxis];
-	Float_t C = (*fieldMap_)[binC_][iAxis];
-	Float_t D = (*fieldMap_)[binD_][iAxis];
-	Float_t E = (*fieldMap_)[binE_][iAxis];
-	Float_t F = (*fieldMap_)[binF_][iAxis];
-	Float_t G = (*fieldMap_)[binG_][iAxis];
-	Float_t H = (*fieldMap_)[binH_][iAxis];
+	const floatArray& theMap = *fieldMap_;
+	Float_t A = theMap[info.bins_[0]][iAxis];
+	Float_t B = theMap[info.bins_[1]][iAxis];
+	Float_t C = theMap[info.bins_[2]][iAxis];
+	Float_t D = theMap[info.bins_[3]][iAxis];
+	Float_t E = theMap[info.bins_[4]][iAxis];
+	Float_t F = theMap[info.bins_[5]][iAxis];
+	Float_t G = theMap[info.bins_[6]][iAxis];
+	Float_t H = theMap[info.bins_[7]][iAxis];
 
 	// Perform linear interpolation along x
-	Float_t F00 = A*xFrac1_ + B*xFrac_;
-	Float_t F10 = C*xFrac1_ + D*xFrac_;
-	Float_t F01 = E*xFrac1_ + F*xFrac_;
-	Float_t F11 = G*xFrac1_ + H*xFrac_;
+	Float_t F00 = A*info.xFrac1_ + B*info.xFrac_;
+	Float_t F10 = C*info.xFrac1_ + D*info.xFrac_;
+	Float_t F01 = E*info.xFrac1_ + F*info.xFrac_;
+	Float_t F11 = G*info.xFrac1_ + H*info.xFrac_;
 
 	// Linear interpolation along y
-	Float_t F0 = F00*yFrac1_ + F10*yFrac_;
-	Float_t F1 = F01*yFrac1_ + F11*yFrac_;
+	Float_t F0 = F00*info.yFrac1_ + F10*info.yFrac_;
+	Float_t F1 = F01*info.yFrac1_ + F11*info.yFrac_;
 
 	// Linear interpolation along z
-	result = F0*zFrac1_ + F1*zFrac_;
+	result = F0*info.zFrac1_ + F1*info.zFrac_;
 
     }
 
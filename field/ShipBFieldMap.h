@@ -9,19 +9,26 @@
 #include "TGeoMatrix.h"
 #include "TVirtualMagField.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+class ShipBFieldMapSoA;
+
 class ShipBFieldMap : public TVirtualMagField
 {
 
  public:
 
+   //! Enumeration to specify the interpolation backend
+   enum InterpolationMode {Scalar = 0, SIMD};
+
     //! Constructor
    /*!
      \param [in] label A descriptive name/title/label for this field
-     \param [in] mapFileName The name of the field map file (distances in cm, fields in Tesla)
+     \param [in] mapFileName The name of the field map file (distances in cm, fields in Tesla).
+     Binary ".bmap" files are memory mapped and always use the SIMD interpolation mode
      \param [in] xOffset The x global coordinate shift to position the field map (cm)
      \param [in] yOffset The y global coordinate shift to position the field map (cm)
      \param [in] zOffset The z global coordinate shift to position the field map (cm)
@@ -30,6 +37,8 @@ class ShipBFieldMap : public TVirtualMagField
      \param [in] psi The third Euler rotation angle about the new z axis (degrees)
      \param [in] scale The field magnitude scaling factor (default = 1.0)
      \param [in] isSymmetric Boolean to specify if we have quadrant symmetry (default = false)
+     \param [in] mode The interpolation backend: Scalar uses the vector of 3-vectors per bin,
+     SIMD uses aligned Bx, By, Bz arrays with a vectorised trilinear blend (default = Scalar)
    */
    ShipBFieldMap(const std::string& label,
                  const std::string& mapFileName,
@@ -40,7 +49,8 @@ class ShipBFieldMap : public TVirtualMagField
                  Float_t theta = 0.0,
                  Float_t psi = 0.0,
                  Float_t scale = 1.0,
-                 Bool_t isSymmetric = kFALSE);
+                 Bool_t isSymmetric = kFALSE,
+                 InterpolationMode mode = Scalar);
 
    //! Copy constructor with a new global transformation. Use this if you want
    //! to reuse the same field map information elsewhere in the geometry
@@ -54,7 +64,7 @@ class ShipBFieldMap : public TVirtualMagField
      \param [in] newTheta The second Euler rotation angle about the new x axis (degrees)
      \param [in] newPsi The third Euler rotation angle about the new z axis (degrees)
      \param [in] newScale The field magnitude scaling factor (default = 1.0)
-    \returns a copy of the field map object "rhs", keeping the same fieldMap pointer
+    \returns a copy of the field map object "rhs", keeping the same field map data and interpolation mode
    */
    ShipBFieldMap(const std::string& newName,
                  const ShipBFieldMap& rhs,
@@ -69,21 +79,51 @@ class ShipBFieldMap : public TVirtualMagField
    //! Destructor
    virtual ~ShipBFieldMap();
 
-   //! Implementation of evaluating the B field
+   //! Implementation of evaluating the B field, which calls GetFieldValue()
    /*!
      \param [in] position The x,y,z global coordinates of the point (cm)
      \param [out] B The x,y,z components of the magnetic field (kGauss = 0.1 tesla)
    */
    virtual void Field(const Double_t* position, Double_t* B);
 
+   //! Evaluate the B field without modifying the object. All intermediate
+   //! interpolation quantities are kept on the stack, so the same map (and its
+   //! copies, which share the same read-only map data) can be queried concurrently
+   //! from many threads
+   /*!
+     \param [in] position The x,y,z global coordinates of the point (cm)
+     \param [out] B The x,y,z components of the magnetic field (kGauss = 0.1 tesla)
+   */
+   void GetFieldValue(const Double_t* position, Double_t* B) const;
+
    //! Typedef for a vector containing a vector of floats
    typedef std::vector<std::vector<Float_t>> floatArray;
 
    //! Retrieve the field map
    /*!
-     \returns the field map
+     \returns the field map, which is empty when using the SIMD interpolation mode
+   */
+   const floatArray* getFieldMap() const { return fieldMap_.get(); }
+
+   //! Retrieve the structure-of-arrays field map
+   /*!
+     \returns the SoA field map, which is null when using the Scalar interpolation mode
    */
-   floatArray* getFieldMap() const { return fieldMap_; }
+   const ShipBFieldMapSoA* getSoAFieldMap() const { return soaMap_.get(); }
+
+   //! Write the field map data in the binary (".bmap") format, which can be memory
+   //! mapped read-only and used directly as the interpolation storage
+   /*!
+     \param [in] fileName The name of the output binary file
+     \returns true if the file was written successfully
+   */
+   Bool_t writeBinaryFile(const std::string& fileName) const;
+
+   //! Get the interpolation backend used by this map
+   /*!
+     \returns the interpolation mode enumeration
+   */
+   InterpolationMode GetInterpolationMode() const { return mode_; }
 
    //! Set the x global coordinate shift
    /*!
@@ -283,6 +323,13 @@ class ShipBFieldMap : public TVirtualMagField
    */
    Bool_t HasSymmetry() const { return isSymmetric_; }
 
+   //! Get the global axis-aligned box enclosing the map validity range
+   /*!
+     \param [out] lo The lowest x,y,z global coordinates of the box (cm)
+     \param [out] hi The highest x,y,z global coordinates of the box (cm)
+   */
+   void GetGlobalBounds(Double_t* lo, Double_t* hi) const;
+
    //! Get the boolean flag to specify if we are a "copy"
    /*!
      \returns the boolean copy flag status
@@ -290,7 +337,7 @@ class ShipBFieldMap : public TVirtualMagField
    Bool_t IsACopy() const { return isCopy_; }
 
    //! ClassDef for ROOT
-   ClassDef(ShipBFieldMap, 1);
+   ClassDef(ShipBFieldMap, 3);
 
 
  protected:
@@ -318,9 +365,24 @@ class ShipBFieldMap : public TVirtualMagField
     //! Process the text file containing the field map data
     void readTextFile();
 
+    //! Memory map the binary file containing the field map data
+    void readBinaryFile();
+
     // ! Set the coordinate limits from information stored in the datafile
     void setLimits();
 
+    //! Prepare the storage for the N_ field map entries for the interpolation mode
+    void initStorage();
+
+    //! Store the B field components for the given map bin
+    /*!
+      \param [in] index The map bin index
+      \param [in] Bx The x component of the field (kGauss)
+      \param [in] By The y component of the field (kGauss)
+      \param [in] Bz The z component of the field (kGauss)
+    */
+    void storeBin(Int_t index, Float_t Bx, Float_t By, Float_t Bz);
+
     //! Check to see if a point is within the map validity range
     /*!
       \param [in] x The x coordinate of the point (cm)
@@ -328,7 +390,7 @@ class ShipBFieldMap : public TVirtualMagField
       \param [in] z The z coordinate of the point (cm)
       \returns true/false if the point is inside the field map range
     */
-    Bool_t insideRange(Float_t x, Float_t y, Float_t z);
+    Bool_t insideRange(Float_t x, Float_t y, Float_t z) const;
 
     //! Typedef for an int-double pair
     typedef std::pair<Int_t, Float_t> binPair;
@@ -339,7 +401,7 @@ class ShipBFieldMap : public TVirtualMagField
       \param [in] theAxis The coordinate axis (CoordAxis enumeration for x, y or z)
       \returns the bin number and fractional distance from the leftmost bin edge as a pair
     */
-    binPair getBinInfo(Float_t x, CoordAxis theAxis);
+    binPair getBinInfo(Float_t x, CoordAxis theAxis) const;
 
     //! Find the vector entry of the field map data given the bins iX, iY and iZ
     /*!
@@ -348,19 +410,50 @@ class ShipBFieldMap : public TVirtualMagField
       \param [in] iZ The bin along the z axis
       \returns the index entry for the field map data vector
     */
-    Int_t getMapBin(Int_t iX, Int_t iY, Int_t iZ);
+    Int_t getMapBin(Int_t iX, Int_t iY, Int_t iZ) const;
+
+    //! Structure to hold the neighbouring bins and fractional bin distances
+    //! needed for the trilinear interpolation at one point
+    struct interpInfo {
+
+	//! The map entries of the neighbouring bins A to H
+	Int_t bins_[8];
+
+	//! Fractional bin distance along x
+	Float_t xFrac_;
+	//! Fractional bin distance along y
+	Float_t yFrac_;
+	//! Fractional bin distance along z
+	Float_t zFrac_;
+
+	//! Complimentary fractional bin distance along x
+	Float_t xFrac1_;
+	//! Complimentary fractional bin distance along y
+	Float_t yFrac1_;
+	//! Complimentary fractional bin distance along z
+	Float_t zFrac1_;
+
+    };
 
-    //! Calculate the magnetic field component using trilinear interpolation.
-    //! This function uses the various "binX" integers and "uFrac" variables
+    //! Calculate the magnetic field component using trilinear interpolation
     /*!
       \param [in] theAxis The coordinate axis (CoordAxis enumeration for x, y or z)
+      \param [in] info The neighbouring bins and fractional distances of the point
       \returns the magnetic field component for the given axis
     */
-    Float_t BInterCalc(CoordAxis theAxis);
+    Float_t BInterCalc(CoordAxis theAxis, const interpInfo& info) const;
 
     //! Store the field map information as a vector of 3 floats.
-    //! Map data ordering is given by first incrementing z, then y, then x
-    floatArray* fieldMap_;
+    //! Map data ordering is given by first incrementing z, then y, then x.
+    //! This is only filled when reading the map file and is shared by all copies
+    std::shared_ptr<floatArray> fieldMap_; //!
+
+    //! The structure-of-arrays field map storage, used for the SIMD interpolation mode.
+    //! This is only filled when reading the map file and is shared by all copies
+    std::shared_ptr<ShipBFieldMapSoA> soaMap_; //!
+
+    //! The interpolation backend
+    InterpolationMode mode_;
 
     //! The name of the map file
     std::string mapFileName_;
@@ -449,48 +542,6 @@ class ShipBFieldMap : public TVirtualMagField
     //! Double converting Tesla to kiloGauss (for VMC/FairRoot B field units)
     Float_t Tesla_;
 
-    //! Bin A for the trilinear interpolation
-    Int_t binA_;
-
-    //! Bin B for the trilinear interpolation
-    Int_t binB_;
-
-    //! Bin C for the trilinear interpolation
-    Int_t binC_;
-
-    //! Bin D for the trilinear interpolation
-    Int_t binD_;
-
-    //! Bin E for the trilinear interpolation
-    Int_t binE_;
-
-    //! Bin F for the trilinear interpolation
-    Int_t binF_;
-
-    //! Bin G for the trilinear interpolation
-    Int_t binG_;
-
-    //! Bin H for the trilinear interpolation
-    Int_t binH_;
-
-    //! Fractional bin distance along x
-    Float_t xFrac_;
-
-    //! Fractional bin distance along y
-    Float_t yFrac_;
-
-    //! Fractional bin distance along z
-    Float_t zFrac_;
-
-    //! Complimentary fractional bin distance along x
-    Float_t xFrac1_;
-
-    //! Complimentary fractional bin distance along y
-    Float_t yFrac1_;
-
-    //! Complimentary fractional bin distance along z
-    Float_t zFrac1_;
-
 };
 
 #endif
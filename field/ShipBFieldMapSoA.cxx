@@ -0,0 +1,261 @@
+/*! \class ShipBFieldMapSoA
+  \brief Structure-of-arrays storage and trilinear interpolation engine for ShipBFieldMap
+*/
+
+#include "ShipBFieldMapSoA.h"
+
+#include "FairLogger.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+static_assert(sizeof(ShipBFieldMapSoA::binaryHeader) == 64,
+              "The binary field map header must be 64 bytes to keep the arrays aligned");
+
+ShipBFieldMapSoA::ShipBFieldMapSoA(Int_t Nx, Int_t Ny, Int_t Nz,
+                                   Float_t xMin, Float_t dx,
+                                   Float_t yMin, Float_t dy,
+                                   Float_t zMin, Float_t dz) :
+    Nx_(Nx), Ny_(Ny), Nz_(Nz), N_(Nx*Ny*Nz),
+    nPadded_(paddedSize(N_)),
+    xMin_(xMin), dx_(dx),
+    yMin_(yMin), dy_(dy),
+    zMin_(zMin), dz_(dz),
+    buffer_(0), mapping_(0), mappingSize_(0),
+    Bx_(0), By_(0), Bz_(0)
+{
+    // All three padded arrays start on an aligned boundary within one buffer
+    buffer_ = static_cast<Float_t*>(::operator new[](3*nPadded_*sizeof(Float_t),
+                                                     std::align_val_t(alignment_)));
+    std::fill(buffer_, buffer_ + 3*nPadded_, 0.0);
+
+    Bx_ = buffer_;
+    By_ = buffer_ + nPadded_;
+    Bz_ = buffer_ + 2*nPadded_;
+}
+
+ShipBFieldMapSoA::ShipBFieldMapSoA(const binaryHeader& header, void* mapping,
+                                   size_t mappingSize) :
+    Nx_(header.Nx_), Ny_(header.Ny_), Nz_(header.Nz_), N_(header.Nx_*header.Ny_*header.Nz_),
+    nPadded_(paddedSize(N_)),
+    xMin_(header.xMin_), dx_(header.dx_),
+    yMin_(header.yMin_), dy_(header.dy_),
+    zMin_(header.zMin_), dz_(header.dz_),
+    buffer_(0), mapping_(mapping), mappingSize_(mappingSize),
+    Bx_(0), By_(0), Bz_(0)
+{
+    // The arrays directly follow the header in the mapped file
+    const Float_t* data = reinterpret_cast<const Float_t*>(static_cast<const char*>(mapping_) +
+                                                           header.headerSize_);
+    Bx_ = data;
+    By_ = data + nPadded_;
+    Bz_ = data + 2*nPadded_;
+}
+
+ShipBFieldMapSoA::~ShipBFieldMapSoA()
+{
+    if (buffer_) {
+        ::operator delete[](buffer_, std::align_val_t(alignment_));
+        buffer_ = 0;
+    }
+
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+        mapping_ = 0;
+    }
+}
+
+size_t ShipBFieldMapSoA::paddedSize(Int_t N)
+{
+    const size_t blockSize = alignment_/sizeof(Float_t);
+    return ((static_cast<size_t>(N) + blockSize - 1)/blockSize)*blockSize;
+}
+
+ShipBFieldMapSoA* ShipBFieldMapSoA::mapBinaryFile(const std::string& fileName,
+                                                  binaryHeader& header)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG(ERROR) << "ShipBFieldMapSoA: could not open the binary field map " << fileName;
+        return 0;
+    }
+
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || static_cast<size_t>(fileInfo.st_size) < sizeof(binaryHeader)) {
+        LOG(ERROR) << "ShipBFieldMapSoA: " << fileName << " is too small to be a binary field map";
+        close(fd);
+        return 0;
+    }
+
+    const size_t fileSize = fileInfo.st_size;
+
+    // The mapping stays valid after the file descriptor is closed
+    void* mapping = mmap(0, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        LOG(ERROR) << "ShipBFieldMapSoA: could not memory map " << fileName;
+        return 0;
+    }
+
+    std::memcpy(&header, mapping, sizeof(binaryHeader));
+
+    Bool_t valid(kTRUE);
+
+    if (std::memcmp(header.magic_, binaryMagic(), sizeof(header.magic_)) != 0) {
+        LOG(ERROR) << "ShipBFieldMapSoA: " << fileName << " is not a binary field map";
+        valid = kFALSE;
+    } else if (header.version_ != binaryVersion_ || header.headerSize_ != sizeof(binaryHeader)) {
+        // A byte-swapped file from a different architecture also ends up here
+        LOG(ERROR) << "ShipBFieldMapSoA: unsupported binary field map version "
+                   << header.version_ << " in " << fileName;
+        valid = kFALSE;
+    } else if (header.Nx_ < 1 || header.Ny_ < 1 || header.Nz_ < 1) {
+        LOG(ERROR) << "ShipBFieldMapSoA: invalid binning in " << fileName;
+        valid = kFALSE;
+    } else {
+        const Int_t N = header.Nx_*header.Ny_*header.Nz_;
+        const size_t expectedSize = header.headerSize_ + 3*paddedSize(N)*sizeof(Float_t);
+        if (fileSize != expectedSize) {
+            LOG(ERROR) << "ShipBFieldMapSoA: expected " << expectedSize << " bytes in "
+                       << fileName << " but found " << fileSize;
+            valid = kFALSE;
+        }
+    }
+
+    if (!valid) {
+        munmap(mapping, fileSize);
+        return 0;
+    }
+
+    return new ShipBFieldMapSoA(header, mapping, fileSize);
+}
+
+Bool_t ShipBFieldMapSoA::writeBinaryFile(const std::string& fileName,
+                                         const binaryHeader& header) const
+{
+    binaryHeader theHeader(header);
+    std::memcpy(theHeader.magic_, binaryMagic(), sizeof(theHeader.magic_));
+    theHeader.version_ = binaryVersion_;
+    theHeader.headerSize_ = sizeof(binaryHeader);
+
+    if (theHeader.Nx_*theHeader.Ny_*theHeader.Nz_ != N_) {
+        LOG(ERROR) << "ShipBFieldMapSoA: header binning does not match the " << N_ << " map bins";
+        return kFALSE;
+    }
+
+    std::ofstream theFile(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!theFile.is_open()) {
+        LOG(ERROR) << "ShipBFieldMapSoA: could not create the binary field map " << fileName;
+        return kFALSE;
+    }
+
+    theFile.write(reinterpret_cast<const char*>(&theHeader), sizeof(binaryHeader));
+
+    // Each array is written with its zero padding, matching the in-memory layout
+    const std::streamsize nBytes = nPadded_*sizeof(Float_t);
+    theFile.write(reinterpret_cast<const char*>(Bx_), nBytes);
+    theFile.write(reinterpret_cast<const char*>(By_), nBytes);
+    theFile.write(reinterpret_cast<const char*>(Bz_), nBytes);
+
+    theFile.close();
+
+    if (theFile.fail()) {
+        LOG(ERROR) << "ShipBFieldMapSoA: error writing the binary field map " << fileName;
+        return kFALSE;
+    }
+
+    return kTRUE;
+}
+
+Bool_t ShipBFieldMapSoA::locate(Float_t u, Float_t uMin, Float_t du, Int_t Nu,
+                                Int_t& iBin, Float_t& frac)
+{
+    if (du < 1e-10) {return kFALSE;}
+
+    // Get the number of fractional bin widths the point is from the first bin,
+    // where the integer part is the bin number
+    Float_t dist = (u - uMin)/du;
+    if (dist < 0.0) {return kFALSE;}
+
+    iBin = static_cast<Int_t>(dist);
+    frac = (dist - iBin*1.0);
+
+    if (iBin < 0 || iBin >= Nu) {return kFALSE;}
+
+    // A point on the last bin edge uses the last bin pair with a unit
+    // fraction, so that the upper neighbour index is always valid
+    if (Nu > 1 && iBin > Nu - 2) {
+        frac += iBin - (Nu - 2);
+        iBin = Nu - 2;
+    }
+
+    return kTRUE;
+}
+
+Bool_t ShipBFieldMapSoA::interpolate(Float_t x, Float_t y, Float_t z, Float_t* B) const
+{
+    Int_t iX(0), iY(0), iZ(0);
+    Float_t xFrac(0.0), yFrac(0.0), zFrac(0.0);
+
+    if (!locate(x, xMin_, dx_, Nx_, iX, xFrac) ||
+        !locate(y, yMin_, dy_, Ny_, iY, yFrac) ||
+        !locate(z, zMin_, dz_, Nz_, iZ, zFrac)) {return kFALSE;}
+
+    const Float_t xFrac1 = 1.0 - xFrac;
+    const Float_t yFrac1 = 1.0 - yFrac;
+    const Float_t zFrac1 = 1.0 - zFrac;
+
+    // Index strides to the neighbouring bins, which are zero
+    // along any axis that only has one bin
+    const Int_t sX = (Nx_ > 1) ? Ny_*Nz_ : 0;
+    const Int_t sY = (Ny_ > 1) ? Nz_ : 0;
+    const Int_t sZ = (Nz_ > 1) ? 1 : 0;
+
+    // The lower-x corners in (y,z) order: (0,0), (0,1), (1,0), (1,1)
+    const Int_t base = (iX*Ny_ + iY)*Nz_ + iZ;
+    const Int_t corner[4] = {base, base + sZ, base + sY, base + sY + sZ};
+
+    // Gather the 8 corners for all 3 components in one pass, using 4 lanes
+    // per corner (Bx, By, Bz, 0) for the lower and upper x bins
+    alignas(64) Float_t xLo[16];
+    alignas(64) Float_t xHi[16];
+
+    for (Int_t j = 0; j < 4; j++) {
+        const Int_t i0 = corner[j];
+        const Int_t i1 = i0 + sX;
+        xLo[4*j] = Bx_[i0]; xLo[4*j + 1] = By_[i0]; xLo[4*j + 2] = Bz_[i0]; xLo[4*j + 3] = 0.0;
+        xHi[4*j] = Bx_[i1]; xHi[4*j + 1] = By_[i1]; xHi[4*j + 2] = Bz_[i1]; xHi[4*j + 3] = 0.0;
+    }
+
+    // Linear interpolation along x: 16 lanes ordered as (y,z) corner pairs
+    alignas(64) Float_t Fyz[16];
+    for (Int_t k = 0; k < 16; k++) {
+        Fyz[k] = xLo[k]*xFrac1 + xHi[k]*xFrac;
+    }
+
+    // Linear interpolation along y: 8 lanes ordered as z0, z1
+    alignas(32) Float_t Fz[8];
+    for (Int_t k = 0; k < 8; k++) {
+        Fz[k] = Fyz[k]*yFrac1 + Fyz[k + 8]*yFrac;
+    }
+
+    // Linear interpolation along z
+    alignas(16) Float_t F[4];
+    for (Int_t k = 0; k < 4; k++) {
+        F[k] = Fz[k]*zFrac1 + Fz[k + 4]*zFrac;
+    }
+
+    B[0] = F[0];
+    B[1] = F[1];
+    B[2] = F[2];
+
+    return kTRUE;
+}
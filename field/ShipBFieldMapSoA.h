@@ -0,0 +1,246 @@
+/*! \class ShipBFieldMapSoA
+  \brief Structure-of-arrays storage and trilinear interpolation engine for ShipBFieldMap
+
+  The Bx, By and Bz components are each stored in their own contiguous, 64-byte
+  aligned array, using the same (iX*Ny + iY)*Nz + iZ binning order as the ROOT and
+  text field map files. For each query, the 8 corner values of all 3 components are
+  gathered in one pass into fixed-width lane buffers, and the x, y and z linear
+  blends are then done as element-wise operations over 16, 8 and 4 lanes. These
+  loops have no loop-carried dependencies, so the compiler emits packed SIMD
+  instructions for them, while the order of the floating point operations is the
+  same as the standard ShipBFieldMap interpolation.
+
+  The arrays are either allocated on the heap, or are a read-only memory mapping of
+  a binary field map file. The binary file (version 1) is the 64 byte binaryHeader
+  followed by the Bx, By and Bz arrays (kGauss, native byte order), each zero-padded
+  to a multiple of 16 floats, which is exactly the in-memory layout. Mapped maps are
+  used without any copying, and all processes on a node that use the same file share
+  the same physical memory through the page cache.
+*/
+
+#ifndef ShipBFieldMapSoA_H
+#define ShipBFieldMapSoA_H
+
+#include "Rtypes.h"
+
+#include <string>
+
+class ShipBFieldMapSoA
+{
+
+ public:
+
+    //! Header of the binary field map file
+    struct binaryHeader {
+
+        //! The file type identifier "SHIPBMAP"
+        char magic_[8];
+        //! The format version number
+        UInt_t version_;
+        //! The size of this header in bytes, which is also the offset of the Bx array
+        UInt_t headerSize_;
+
+        //! The number of bins along x
+        Int_t Nx_;
+        //! The number of bins along y
+        Int_t Ny_;
+        //! The number of bins along z
+        Int_t Nz_;
+
+        //! The minimum, maximum and bin width along x (cm)
+        Float_t xMin_, xMax_, dx_;
+        //! The minimum, maximum and bin width along y (cm)
+        Float_t yMin_, yMax_, dy_;
+        //! The minimum, maximum and bin width along z (cm)
+        Float_t zMin_, zMax_, dz_;
+
+    };
+
+    //! Constructor, allocating (zero-initialised) storage for Nx*Ny*Nz bins
+    /*!
+      \param [in] Nx The number of bins along x
+      \param [in] Ny The number of bins along y
+      \param [in] Nz The number of bins along z
+      \param [in] xMin The minimum x coordinate of the map (cm)
+      \param [in] dx The bin width along x (cm)
+      \param [in] yMin The minimum y coordinate of the map (cm)
+      \param [in] dy The bin width along y (cm)
+      \param [in] zMin The minimum z coordinate of the map (cm)
+      \param [in] dz The bin width along z (cm)
+    */
+    ShipBFieldMapSoA(Int_t Nx, Int_t Ny, Int_t Nz,
+                     Float_t xMin, Float_t dx,
+                     Float_t yMin, Float_t dy,
+                     Float_t zMin, Float_t dz);
+
+    //! Destructor, which frees the heap storage or unmaps the binary file
+    ~ShipBFieldMapSoA();
+
+    //! Memory map a binary field map file (read-only) and use it as the storage
+    /*!
+      \param [in] fileName The name of the binary field map file
+      \param [out] header The header information stored in the file
+      \returns a new map object using the file contents, or null if the file is not valid
+    */
+    static ShipBFieldMapSoA* mapBinaryFile(const std::string& fileName, binaryHeader& header);
+
+    //! Write the field map in the binary file format
+    /*!
+      \param [in] fileName The name of the output binary file
+      \param [in] header The coordinate limits and binning; the identifier, version and
+      header size are set by this function
+      \returns true if the file was written successfully
+    */
+    Bool_t writeBinaryFile(const std::string& fileName, const binaryHeader& header) const;
+
+    //! Set the field components for the given map bin. Only valid for heap storage
+    /*!
+      \param [in] index The map bin index (iX*Ny + iY)*Nz + iZ
+      \param [in] Bx The x component of the field
+      \param [in] By The y component of the field
+      \param [in] Bz The z component of the field
+    */
+    void setBin(Int_t index, Float_t Bx, Float_t By, Float_t Bz)
+    {
+        buffer_[index] = Bx; buffer_[nPadded_ + index] = By; buffer_[2*nPadded_ + index] = Bz;
+    }
+
+    //! Find the field at the local map position using trilinear interpolation
+    /*!
+      \param [in] x The local x coordinate of the point (cm)
+      \param [in] y The local y coordinate of the point (cm)
+      \param [in] z The local z coordinate of the point (cm)
+      \param [out] B The interpolated x,y,z field components (map units)
+      \returns false if the point is outside the map, in which case B is unchanged
+    */
+    Bool_t interpolate(Float_t x, Float_t y, Float_t z, Float_t* B) const;
+
+    //! Get the total number of bins
+    /*!
+      \returns the total number of bins
+    */
+    Int_t GetNBins() const { return N_; }
+
+    //! Get the array of Bx values
+    /*!
+      \returns the pointer to the contiguous Bx array
+    */
+    const Float_t* GetBx() const { return Bx_; }
+
+    //! Get the array of By values
+    /*!
+      \returns the pointer to the contiguous By array
+    */
+    const Float_t* GetBy() const { return By_; }
+
+    //! Get the array of Bz values
+    /*!
+      \returns the pointer to the contiguous Bz array
+    */
+    const Float_t* GetBz() const { return Bz_; }
+
+    //! Check if the storage is a memory mapped binary file
+    /*!
+      \returns true if the field values are read directly from a mapped file
+    */
+    Bool_t IsMapped() const { return mapping_ != 0; }
+
+    //! The binary file format identifier
+    static const char* binaryMagic() { return "SHIPBMAP"; }
+
+    //! The binary file format version
+    static const UInt_t binaryVersion_ = 1;
+
+ private:
+
+    //! Constructor using the arrays of a memory mapped binary file
+    /*!
+      \param [in] header The header information stored in the file
+      \param [in] mapping The start address of the mapped file
+      \param [in] mappingSize The length of the mapped file in bytes
+    */
+    ShipBFieldMapSoA(const binaryHeader& header, void* mapping, size_t mappingSize);
+
+    //! Copy constructor not implemented
+    ShipBFieldMapSoA(const ShipBFieldMapSoA& rhs);
+
+    //! Copy assignment operator not implemented
+    ShipBFieldMapSoA& operator=(const ShipBFieldMapSoA& rhs);
+
+    //! Get the number of padded entries used for each component array
+    /*!
+      \param [in] N The number of map bins
+      \returns N rounded up to a whole number of alignment blocks
+    */
+    static size_t paddedSize(Int_t N);
+
+    //! Find the lower bin edge index and fractional distance along one axis
+    /*!
+      \param [in] u The coordinate component of the point (cm)
+      \param [in] uMin The minimum coordinate of the map along this axis (cm)
+      \param [in] du The bin width along this axis (cm)
+      \param [in] Nu The number of bins along this axis
+      \param [out] iBin The lower bin edge index, such that iBin + 1 is also valid
+      \param [out] frac The fractional distance of the point from the lower bin edge
+      \returns false if the coordinate is outside the map binning
+    */
+    static Bool_t locate(Float_t u, Float_t uMin, Float_t du, Int_t Nu,
+                         Int_t& iBin, Float_t& frac);
+
+    //! Byte alignment of each component array
+    static const size_t alignment_ = 64;
+
+    //! The number of bins along x
+    Int_t Nx_;
+
+    //! The number of bins along y
+    Int_t Ny_;
+
+    //! The number of bins along z
+    Int_t Nz_;
+
+    //! The total number of bins
+    Int_t N_;
+
+    //! The number of (padded) entries of each component array
+    size_t nPadded_;
+
+    //! The minimum value of x for the map
+    Float_t xMin_;
+
+    //! The bin width along x
+    Float_t dx_;
+
+    //! The minimum value of y for the map
+    Float_t yMin_;
+
+    //! The bin width along y
+    Float_t dy_;
+
+    //! The minimum value of z for the map
+    Float_t zMin_;
+
+    //! The bin width along z
+    Float_t dz_;
+
+    //! The single aligned heap buffer holding the Bx, By and Bz arrays
+    Float_t* buffer_;
+
+    //! The start address of the memory mapped binary file
+    void* mapping_;
+
+    //! The length of the memory mapped binary file in bytes
+    size_t mappingSize_;
+
+    //! Start of the Bx array
+    const Float_t* Bx_;
+
+    //! Start of the By array
+    const Float_t* By_;
+
+    //! Start of the Bz array
+    const Float_t* Bz_;
+
+};
+
+#endif
@@ -4,32 +4,47 @@
 */
 
 #include "ShipCompField.h"
+#include "ShipBFieldMap.h"
+#include "ShipConstField.h"
 
+#include <algorithm>
 #include <iostream>
 
 ShipCompField::ShipCompField(const std::string& label,
 			     TVirtualMagField* firstField) :
     TVirtualMagField(label.c_str()),
-    theFields_()
+    theFields_(),
+    bounds_(),
+    nFieldCalls_(0),
+    nComponentCalls_(0)
 {
     theFields_.push_back(firstField);
+    this->updateBounds();
 }
 
 ShipCompField::ShipCompField(const std::string& label,
 			     TVirtualMagField* firstField,
 			     TVirtualMagField* secondField) :
     TVirtualMagField(label.c_str()),
-    theFields_()
+    theFields_(),
+    bounds_(),
+    nFieldCalls_(0),
+    nComponentCalls_(0)
 {
     theFields_.push_back(firstField);
     theFields_.push_back(secondField);
+    this->updateBounds();
 }
 
 ShipCompField::ShipCompField(const std::string& label,
 			     const std::vector<TVirtualMagField*>& theFields) :
     TVirtualMagField(label.c_str()),
-    theFields_(theFields)
+    theFields_(theFields),
+    bounds_(),
+    nFieldCalls_(0),
+    nComponentCalls_(0)
 {
+    this->updateBounds();
 }
 
 ShipCompField::~ShipCompField()
@@ -38,6 +53,70 @@ ShipCompField::~ShipCompField()
     // the various TVirtualMagField pointers
 }
 
+void ShipCompField::updateBounds()
+{
+
+    // Find the global box of each field for which the region with non-zero
+    // field is known. Other fields (e.g. the Bell or Goliath fields) are
+    // evaluated everywhere
+    bounds_.assign(theFields_.size(), Bounds());
+
+    for (size_t i = 0; i < theFields_.size(); i++) {
+
+	Bounds& box = bounds_[i];
+	box.bounded = kFALSE;
+	TVirtualMagField* theField = theFields_[i];
+
+	if (ShipBFieldMap* mapField = dynamic_cast<ShipBFieldMap*>(theField)) {
+	    mapField->GetGlobalBounds(box.lo, box.hi);
+	    box.bounded = kTRUE;
+	} else if (ShipCompField* compField = dynamic_cast<ShipCompField*>(theField)) {
+	    box.bounded = compField->getBounds(box.lo, box.hi);
+	} else if (ShipConstField* constField = dynamic_cast<ShipConstField*>(theField)) {
+	    box.lo[0] = constField->GetXmin(), box.hi[0] = constField->GetXmax();
+	    box.lo[1] = constField->GetYmin(), box.hi[1] = constField->GetYmax();
+	    box.lo[2] = constField->GetZmin(), box.hi[2] = constField->GetZmax();
+	    box.bounded = kTRUE;
+	}
+
+	if (box.bounded) {
+	    // Widen the box slightly, the fields do their own range checks
+	    // in local (and single precision) coordinates
+	    for (Int_t k = 0; k < 3; k++) {
+		Double_t margin = 1e-3 + 1e-6*(box.hi[k] - box.lo[k]);
+		box.lo[k] -= margin;
+		box.hi[k] += margin;
+	    }
+	}
+
+    }
+
+}
+
+Bool_t ShipCompField::getBounds(Double_t* lo, Double_t* hi) const
+{
+
+    for (Int_t k = 0; k < 3; k++) {
+	lo[k] = 1e30;
+	hi[k] = -1e30;
+    }
+
+    for (size_t i = 0; i < theFields_.size(); i++) {
+
+	if (!theFields_[i]) {continue;}
+	const Bounds& box = bounds_[i];
+	if (!box.bounded) {return kFALSE;}
+	for (Int_t k = 0; k < 3; k++) {
+	    lo[k] = std::min(lo[k], box.lo[k]);
+	    hi[k] = std::max(hi[k], box.hi[k]);
+	}
+
+    }
+
+    return kTRUE;
+
+}
+
 void ShipCompField::Field(const Double_t* position, Double_t* B)
 {
 
@@ -46,12 +125,22 @@ void ShipCompField::Field(const Double_t* position, Double_t* B)
     // First initialise the field components to zero
     B[0] = 0.0, B[1] = 0.0, B[2] = 0.0;
 
-    std::vector<TVirtualMagField*>::const_iterator iter;
-    for (iter = theFields_.begin(); iter != theFields_.end(); ++iter) {
+    nFieldCalls_.fetch_add(1, std::memory_order_relaxed);
 
-	TVirtualMagField* theField = *iter;
+    for (size_t i = 0; i < theFields_.size(); i++) {
+
+	TVirtualMagField* theField = theFields_[i];
 	if (theField) {
 
+	    // Skip fields whose bounding box does not contain the point
+	    const Bounds& box = bounds_[i];
+	    if (box.bounded &&
+		(position[0] < box.lo[0] || position[0] > box.hi[0] ||
+		 position[1] < box.lo[1] || position[1] > box.hi[1] ||
+		 position[2] < box.lo[2] || position[2] > box.hi[2])) {continue;}
+
+	    nComponentCalls_.fetch_add(1, std::memory_order_relaxed);
+
 	    //std::cout<<"Finding field for "<<theField->GetName()<<std::endl;
 
 	    // Find the magnetic field components for this part
@@ -8,6 +8,7 @@
 
 #include "TVirtualMagField.h"
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -60,8 +61,28 @@ class ShipCompField: public TVirtualMagField
    */
    std::vector<TVirtualMagField*> getCompFields() const { return theFields_; }
 
+   //! Recalculate the bounding boxes of the fields, e.g. after changing a map offset
+   void updateBounds();
+
+   //! Get the global axis-aligned box enclosing all of the fields
+   /*!
+     \param [out] lo The lowest x,y,z global coordinates of the box (cm)
+     \param [out] hi The highest x,y,z global coordinates of the box (cm)
+     \returns false if one of the fields has no known bounds (global field)
+   */
+   Bool_t getBounds(Double_t* lo, Double_t* hi) const;
+
+   //! Get the number of calls of Field()
+   ULong64_t getNFieldCalls() const { return nFieldCalls_; }
+
+   //! Get the number of field components evaluated in all Field() calls
+   ULong64_t getNComponentCalls() const { return nComponentCalls_; }
+
+   //! Reset the call counters
+   void resetCounters() { nFieldCalls_ = 0; nComponentCalls_ = 0; }
+
    //! ClassDef for ROOT
-   ClassDef(ShipCompField, 1);
+   ClassDef(ShipCompField, 2);
 
  protected:
 
@@ -74,6 +95,20 @@ class ShipCompField: public TVirtualMagField
     //! The vector of the various magnetic field pointers comprising the composite
     std::vector<TVirtualMagField*> theFields_;
 
+    //! Global bounding box of a field, outside of which the field is zero
+    struct Bounds {
+	Bool_t bounded;
+	Double_t lo[3];
+	Double_t hi[3];
+    };
+
+    //! The bounding boxes, in the same order as theFields_
+    std::vector<Bounds> bounds_; //!
+
+    //! Call counters
+    std::atomic<ULong64_t> nFieldCalls_; //!
+    std::atomic<ULong64_t> nComponentCalls_; //!
+
 };
 
 #endif
@@ -423,7 +423,7 @@ void ShipFieldMaker::defineFieldMap(const stringVect& inputLine, Bool_t useSymme
 
 void ShipFieldMaker::defineFieldMap(const TString& name, const TString& mapFileName,
 				    const TVector3& localCentre, const TVector3& localAngles,
-				    Bool_t useSymmetry)
+				    Bool_t useSymmetry, ShipBFieldMap::InterpolationMode mode)
 {
     // Check if the field is already in the map
     if (!this->gotField(name)) {
@@ -453,7 +453,7 @@ void ShipFieldMaker::defineFieldMap(const TString& name, const TString& mapFileN
 	Float_t scale(1.0);
 
 	ShipBFieldMap* mapField = new ShipBFieldMap(name.Data(), fullFileName, x0, y0, z0,
-						    phi, theta, psi, scale, useSymmetry);
+						    phi, theta, psi, scale, useSymmetry, mode);
 	theFields_[name] = mapField;
 
     } else {
@@ -1420,6 +1420,26 @@ void ShipFieldMaker::generateFieldMap(TString fileName, const float step, const
         myfile.close();
 }
 
+Bool_t ShipFieldMaker::convertFieldMap(const TString& inputFileName,
+				       const TString& outputFileName) const
+{
+
+    // Read the map data without any offsets, rotations or scaling, using the
+    // SoA storage that has the same layout as the binary file
+    ShipBFieldMap theMap("convertedMap", inputFileName.Data(), 0.0, 0.0, 0.0,
+			 0.0, 0.0, 0.0, 1.0, kFALSE, ShipBFieldMap::SIMD);
+
+    Bool_t written = theMap.writeBinaryFile(outputFileName.Data());
+
+    if (verbose_) {
+	std::cout<<"Converted field map "<<inputFileName.Data()<<" to "
+		 <<outputFileName.Data()<<": status = "<<written<<std::endl;
+    }
+
+    return written;
+
+}
+
 ShipFieldMaker::stringVect ShipFieldMaker::splitString(std::string& theString,
 						       std::string& splitter) const {
 
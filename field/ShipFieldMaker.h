@@ -16,6 +16,7 @@
 #ifndef ShipFieldMaker_H
 #define ShipFieldMaker_H
 
+#include "ShipBFieldMap.h"
 #include "ShipCompField.h"
 
 #include "TString.h"
@@ -117,11 +118,13 @@ class ShipFieldMaker : public TG4VUserPostDetConstruction
       \param [in] localCentre The TVector3(x,y,z) offset shift applied to all field map coordinates
       \param [in] localAngles The TVector3(phi, theta, psi) Euler rotation applied to all map coords
       \param [in] useSymmetry Boolean to specify if the map has quadrant symmetry (default = false)
+      \param [in] mode The interpolation backend of the map (default = ShipBFieldMap::Scalar)
     */
     void defineFieldMap(const TString& name, const TString& mapFileName,
 			const TVector3& localCentre = TVector3(0.0, 0.0, 0.0),
 			const TVector3& localAngles = TVector3(0.0, 0.0, 0.0),
-			Bool_t useSymmetry = kFALSE);
+			Bool_t useSymmetry = kFALSE,
+			ShipBFieldMap::InterpolationMode mode = ShipBFieldMap::Scalar);
 
     //! Define a copy of a field map with a coordinate translation and optional rotation
     /*!
@@ -258,6 +261,15 @@ class ShipFieldMaker : public TG4VUserPostDetConstruction
     void generateFieldMap(TString fileName, const float step=2.5, const float xRange=179, const float yRange=317, const float zRange=1515.5, const float zShift=-4996);
     //! Generate fieldMap csv file in the given region
 
+    //! Convert a ROOT or text field map file into the binary (".bmap") format
+    //! that ShipBFieldMap can memory map and use without copying
+    /*!
+      \param [in] inputFileName The name of the ROOT or text field map file
+      \param [in] outputFileName The name of the output binary field map file
+      \returns true if the binary file was written successfully
+    */
+    Bool_t convertFieldMap(const TString& inputFileName, const TString& outputFileName) const;
+
     //! ClassDef for ROOT
     ClassDef(ShipFieldMaker,1);
 
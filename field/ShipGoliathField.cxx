@@ -11,7 +11,10 @@
 #include "TVector3.h"
 #include "TTreeReader.h"
 #include "TTreeReaderValue.h"
+#include "TRandom.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 
@@ -21,10 +24,35 @@ using std::endl;
 using std::setw;
 using std::div;
 
+namespace {
+// z of the field map origin in the FairShip frame [cm]
+const Double_t kZOffset = 350.75;
+
+// position u in units of bins from the first bin centre, clamped to the map:
+// lower centre index, upper centre index and weight of the upper one
+void locate(Double_t u, Int_t n, Int_t& i0, Int_t& i1, Double_t& t)
+{
+  u = std::min(std::max(u, 0.), Double_t(n - 1));
+  i0 = std::max(0, std::min(Int_t(u), n - 2));
+  i1 = std::min(i0 + 1, n - 1);
+  t = u - i0;
+}
+}
+
 
 // -----   Default constructor   -------------------------------------------
 ShipGoliathField::ShipGoliathField()
   : FairField()
+  , fhistbx(nullptr)
+  , fhistby(nullptr)
+  , fhistbz(nullptr)
+  , fNx(0)
+  , fNy(0)
+  , fNz(0)
+  , fInvDx(0.)
+  , fInvDy(0.)
+  , fInvDz(0.)
+  , fInterpolate(kFALSE)
 {
 }
 // -------------------------------------------------------------------------
@@ -34,6 +62,16 @@ ShipGoliathField::ShipGoliathField()
 // -----   Standard constructor   ------------------------------------------
 ShipGoliathField::ShipGoliathField(const char* name)
   : FairField(name)
+  , fhistbx(nullptr)
+  , fhistby(nullptr)
+  , fhistbz(nullptr)
+  , fNx(0)
+  , fNy(0)
+  , fNz(0)
+  , fInvDx(0.)
+  , fInvDy(0.)
+  , fInvDz(0.)
+  , fInterpolate(kFALSE)
 {
 }
 // -------------------------------------------------------------------------
@@ -78,6 +116,7 @@ void ShipGoliathField::Init(const char* fieldfile){
   zmax = histbx->GetZaxis()->GetXmax();
 
   ShipGoliathField::sethistbxyz(histbx, histby, histbz);
+  FillGrid();
 
   /*
   TVector3 bot,top;
@@ -137,13 +176,13 @@ Double_t ShipGoliathField::GetBx(Double_t x, Double_t y, Double_t z)  {
    Double_t bx=0.;
    TH3D* hbx;
 
-   if ((x < xmin )|| (x> xmax) || (y < ymin) || (y>ymax) || ((z-350.75)<zmin) || ((z-350.75)>zmax)) {
+   if ((x < xmin )|| (x> xmax) || (y < ymin) || (y>ymax) || ((z-kZOffset)<zmin) || ((z-kZOffset)>zmax)) {
        return bx;}
     // FairShip: 0 after absorber -384.5<target<-240 -239.9<absorber<0<T1T2<121<Goliath<481<T3T4<755 766.6<RPC<966.6
     hbx=ShipGoliathField::gethistbx();
     Int_t binx = hbx->GetXaxis()->FindBin(x);
     Int_t biny = hbx->GetYaxis()->FindBin(y);
-    Int_t binz = hbx->GetZaxis()->FindBin(z - 350.75);
+    Int_t binz = hbx->GetZaxis()->FindBin(z - kZOffset);
     bx=hbx->GetBinContent(binx,biny,binz)*tesla;
     //cout << "GetBX " << x << ", binx " << binx <<" y "<< y << " biny "<<biny<<" z "<< z << " binz "<<binz<<" Bx= " << bx <<  endl;
    return bx;
@@ -157,12 +196,12 @@ Double_t ShipGoliathField::GetBy(Double_t x, Double_t y, Double_t z) {
     Double_t by=0.;
     TH3D* hby;
 
-   if ((x < xmin )|| (x> xmax) || (y < ymin) || (y>ymax) || ((z-350.75)<zmin) || ((z-350.75)>zmax)) {
+   if ((x < xmin )|| (x> xmax) || (y < ymin) || (y>ymax) || ((z-kZOffset)<zmin) || ((z-kZOffset)>zmax)) {
        return by;}
     hby=ShipGoliathField::gethistby();
     Int_t binx = hby->GetXaxis()->FindBin(x);
     Int_t biny = hby->GetYaxis()->FindBin(y);
-    Int_t binz = hby->GetZaxis()->FindBin(z- 350.75);
+    Int_t binz = hby->GetZaxis()->FindBin(z - kZOffset);
     by=hby->GetBinContent(binx,biny,binz)*tesla;
    return by;
 }
@@ -176,13 +215,13 @@ Double_t ShipGoliathField::GetBz(Double_t x, Double_t y, Double_t z)  {
     Double_t bz=0.;
     TH3D* hbz;
 
-   if ((x < xmin )|| (x> xmax) || (y < ymin) || (y>ymax) || ((z-350.75)<zmin) || ((z-350.75)>zmax)) {
+   if ((x < xmin )|| (x> xmax) || (y < ymin) || (y>ymax) || ((z-kZOffset)<zmin) || ((z-kZOffset)>zmax)) {
        return bz;}
 
     hbz=ShipGoliathField::gethistbz();
     Int_t binx = hbz->GetXaxis()->FindBin(x);
     Int_t biny = hbz->GetYaxis()->FindBin(y);
-    Int_t binz = hbz->GetZaxis()->FindBin(z- 350.75);
+    Int_t binz = hbz->GetZaxis()->FindBin(z - kZOffset);
     bz=hbz->GetBinContent(binx,biny,binz)*tesla;
   return bz;
 }
@@ -192,6 +231,140 @@ Double_t ShipGoliathField::GetBz(Double_t x, Double_t y, Double_t z)  {
 
 
 
+// -----   Field grid   ----------------------------------------------------
+void ShipGoliathField::FillGrid() {
+  fGrid.clear();
+  fNx = fNy = fNz = 0;
+  TH3D* hist[3] = {fhistbx, fhistby, fhistbz};
+  for (TH3D* h : hist) {
+    // only for uniform bins shared by the three components, else GetBx/y/z are used
+    if (!h || h->GetXaxis()->GetXbins()->GetSize() > 0 || h->GetYaxis()->GetXbins()->GetSize() > 0
+        || h->GetZaxis()->GetXbins()->GetSize() > 0 || h->GetNbinsX() != fhistbx->GetNbinsX()
+        || h->GetNbinsY() != fhistbx->GetNbinsY() || h->GetNbinsZ() != fhistbx->GetNbinsZ()) {
+      cout << "ShipGoliathField: field map without common uniform binning, using histogram lookup" << endl;
+      return;
+    }
+  }
+  fNx = fhistbx->GetNbinsX();
+  fNy = fhistbx->GetNbinsY();
+  fNz = fhistbx->GetNbinsZ();
+  fInvDx = fNx / (xmax - xmin);
+  fInvDy = fNy / (ymax - ymin);
+  fInvDz = fNz / (zmax - zmin);
+  fGrid.resize(3 * fNx * fNy * fNz);
+  for (Int_t iz = 0; iz < fNz; iz++) {
+    for (Int_t iy = 0; iy < fNy; iy++) {
+      for (Int_t ix = 0; ix < fNx; ix++) {
+        Int_t index = 3 * (ix + fNx * (iy + fNy * iz));
+        for (Int_t c = 0; c < 3; c++) {
+          fGrid[index + c] = hist[c]->GetBinContent(ix + 1, iy + 1, iz + 1) * tesla;
+        }
+      }
+    }
+  }
+}
+
+// -----   Get all components of field   -----------------------------------
+void ShipGoliathField::Field(const Double_t* point, Double_t* bField) {
+  if (fGrid.empty()) {
+    bField[0] = GetBx(point[0], point[1], point[2]);
+    bField[1] = GetBy(point[0], point[1], point[2]);
+    bField[2] = GetBz(point[0], point[1], point[2]);
+    return;
+  }
+  GetFieldValue(point, bField);
+}
+
+void ShipGoliathField::GetFieldValue(const Double_t* point, Double_t* bField) const {
+  bField[0] = bField[1] = bField[2] = 0.;
+  Double_t x = point[0];
+  Double_t y = point[1];
+  Double_t z = point[2] - kZOffset;
+  if (fGrid.empty() || (x < xmin) || (x > xmax) || (y < ymin) || (y > ymax) || (z < zmin) || (z > zmax)) {
+    return;
+  }
+  // position in units of bins from the lower edge of the map
+  Double_t u = (x - xmin) * fInvDx;
+  Double_t v = (y - ymin) * fInvDy;
+  Double_t w = (z - zmin) * fInvDz;
+  if (!fInterpolate) {
+    Int_t ix = Int_t(u);
+    Int_t iy = Int_t(v);
+    Int_t iz = Int_t(w);
+    // the upper edge of the map belongs to the (empty) overflow bin, as with FindBin
+    if (ix >= fNx || iy >= fNy || iz >= fNz) {
+      return;
+    }
+    const Float_t* b = &fGrid[3 * (ix + fNx * (iy + fNy * iz))];
+    bField[0] = b[0];
+    bField[1] = b[1];
+    bField[2] = b[2];
+    return;
+  }
+  Int_t ix[2], iy[2], iz[2];
+  Double_t tx, ty, tz;
+  locate(u - 0.5, fNx, ix[0], ix[1], tx);
+  locate(v - 0.5, fNy, iy[0], iy[1], ty);
+  locate(w - 0.5, fNz, iz[0], iz[1], tz);
+  Double_t wx[2] = {1. - tx, tx};
+  Double_t wy[2] = {1. - ty, ty};
+  Double_t wz[2] = {1. - tz, tz};
+  for (Int_t k = 0; k < 2; k++) {
+    for (Int_t j = 0; j < 2; j++) {
+      for (Int_t i = 0; i < 2; i++) {
+        Double_t weight = wx[i] * wy[j] * wz[k];
+        const Float_t* b = &fGrid[3 * (ix[i] + fNx * (iy[j] + fNy * iz[k]))];
+        bField[0] += weight * b[0];
+        bField[1] += weight * b[1];
+        bField[2] += weight * b[2];
+      }
+    }
+  }
+}
+
+// -----   Compare grid with histogram lookup   ----------------------------
+Double_t ShipGoliathField::CheckGrid(Int_t nPoints) {
+  Double_t maxDiff = 0.;
+  if (fGrid.empty()) {
+    cout << "ShipGoliathField::CheckGrid: no field grid" << endl;
+    return maxDiff;
+  }
+  TH3D* hist[3] = {fhistbx, fhistby, fhistbz};
+  // TH3::Interpolate is only defined between the outermost bin centres
+  Double_t lo[3] = {xmin, ymin, zmin};
+  Double_t hi[3] = {xmax, ymax, zmax};
+  if (fInterpolate) {
+    Double_t half[3] = {0.5 / fInvDx, 0.5 / fInvDy, 0.5 / fInvDz};
+    for (Int_t c = 0; c < 3; c++) {
+      lo[c] += half[c];
+      hi[c] -= half[c];
+    }
+  }
+  Double_t point[3], b[3], ref[3];
+  for (Int_t n = 0; n < nPoints; n++) {
+    for (Int_t c = 0; c < 3; c++) {
+      point[c] = gRandom->Uniform(lo[c], hi[c]);
+    }
+    point[2] += kZOffset;
+    GetFieldValue(point, b);
+    if (fInterpolate) {
+      for (Int_t c = 0; c < 3; c++) {
+        ref[c] = hist[c]->Interpolate(point[0], point[1], point[2] - kZOffset) * tesla;
+      }
+    } else {
+      ref[0] = GetBx(point[0], point[1], point[2]);
+      ref[1] = GetBy(point[0], point[1], point[2]);
+      ref[2] = GetBz(point[0], point[1], point[2]);
+    }
+    for (Int_t c = 0; c < 3; c++) {
+      maxDiff = std::max(maxDiff, std::fabs(b[c] - ref[c]));
+    }
+  }
+  cout << "ShipGoliathField::CheckGrid: largest difference to histogram lookup " << maxDiff << " kG in " << nPoints
+       << " points" << endl;
+  return maxDiff;
+}
+
 // -----   Screen output   -------------------------------------------------
 void ShipGoliathField::Print() {
   cout << "======================================================" << endl;
@@ -18,6 +18,8 @@
 #include "TH3D.h"
 #include "TVector3.h"
 
+#include <vector>
+
 class ShipGoliathField : public FairField
 {
 
@@ -54,6 +56,23 @@ class ShipGoliathField : public FairField
   virtual Double_t GetBy(Double_t x, Double_t y, Double_t z);
   virtual Double_t GetBz(Double_t x, Double_t y, Double_t z);
 
+  /** Get all components of the field at a given point, with one bin lookup
+   ** in the field grid made by Init
+   ** @param point   Point coordinates [cm]
+   ** @param bField  Field components [kG]
+   **/
+  virtual void Field(const Double_t* point, Double_t* bField);
+  void GetFieldValue(const Double_t* point, Double_t* bField) const;
+
+  /** Trilinear interpolation between the bin centres instead of the bin content **/
+  void SetInterpolation(Bool_t interpolate) { fInterpolate = interpolate; };
+  Bool_t GetInterpolation() const { return fInterpolate; };
+
+  /** Compare Field with GetBx, GetBy, GetBz at nPoints random points inside the map,
+   ** returns the largest absolute difference of a component [kG]
+   **/
+  Double_t CheckGrid(Int_t nPoints = 10000);
+
   /** Screen output **/
   virtual void Print();
 
@@ -87,9 +106,16 @@ class ShipGoliathField : public FairField
 
    Double_t xmin, xmax, ymin, ymax, zmin, zmax;
 
+   /** copy the three histograms into the interleaved field grid **/
+   void FillGrid();
+
+   std::vector<Float_t> fGrid;   //! Bx, By, Bz per bin, x fastest [kG]
+   Int_t fNx, fNy, fNz;          //!
+   Double_t fInvDx, fInvDy, fInvDz;   //! inverse bin widths
+   Bool_t fInterpolate;          //!
 
 
-ClassDef(ShipGoliathField, 2);
+ClassDef(ShipGoliathField, 3);
 
 };
 
@@ -86,6 +86,7 @@ hcal::hcal()
     fModuleLength(0.),
     fVolIdMax(0),
     fFirstNumber(0),
+    fHitIndex(),
     fVolArr(),
     fModule(NULL),
     fScTile(NULL),
@@ -156,6 +157,7 @@ hcal::hcal(const char* name, Bool_t active, const char* fileGeo)
     fModuleLength(0.),
     fVolIdMax(0),
     fFirstNumber(0),
+    fHitIndex(),
     fVolArr(),
     fModule(NULL),
     fScTile(NULL),
@@ -309,6 +311,7 @@ void hcal::SetHcalCuts(Int_t medium)
 void hcal::FinishPrimary()
 {
   fFirstNumber=fLiteCollection->GetEntriesFast();
+  fHitIndex.clear();
 }
 
 //_____________________________________________________________________________
@@ -508,13 +511,11 @@ void hcal::FillWallPoint()
 
 hcalPoint* hcal::FindHit(Int_t VolId, Int_t TrackId)
 {
-  for(Int_t i=fFirstNumber;i<fLiteCollection->GetEntriesFast();i++)
-  {
-    hcalPoint* point=(hcalPoint*)fLiteCollection->At(i);
-    if (point->GetTrackID()==TrackId&&point->GetDetectorID()==VolId)
-      return point;
-  }
-  return NULL;
+  /** Only hits of the current primary are indexed **/
+  std::unordered_map<Long64_t, Int_t>::const_iterator p=fHitIndex.find(HitKey(VolId, TrackId));
+  if (p==fHitIndex.end())
+    return NULL;
+  return (hcalPoint*)fLiteCollection->At(p->second);
 }
 //-----------------------------------------------------------------------------
 Bool_t hcal::FillLitePoint(Int_t volnum)
@@ -550,8 +551,11 @@ Bool_t hcal::FillLitePoint(Int_t volnum)
   if ((oldHit=FindHit(fVolumeID,fTrackID))!=NULL)
     ChangeHit(oldHit);
   else
+  {
     // Create hcalPoint for scintillator volumes
     newHit = AddLiteHit(fTrackID, fVolumeID, fTime, fELoss);
+    fHitIndex[HitKey(fVolumeID, fTrackID)]=fLiteCollection->GetEntriesFast()-1;
+  }
 
 
   return kTRUE;
@@ -565,6 +569,7 @@ void hcal::EndOfEvent() {
   fLiteCollection->Clear();
   fPosIndex = 0;
   fFirstNumber=0;
+  fHitIndex.clear();
 }
 // -------------------------------------------------------------------------
 
@@ -584,6 +589,7 @@ void hcal::Reset()
   fLiteCollection->Clear();
   ResetParameters();
   fFirstNumber=0;
+  fHitIndex.clear();
 }
 // -------------------------------------------------------------------------
 
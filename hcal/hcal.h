@@ -20,6 +20,7 @@
 #include "TVector3.h"
 
 #include <list>
+#include <unordered_map>
 
 class hcalPoint;
 class FairVolume;
@@ -102,6 +103,9 @@ private:
   void ResetParameters();
   void SetHcalCuts(Int_t medium);
   hcalPoint* FindHit(Int_t VolId, Int_t TrackId);
+  /** Key of the hit index for given volume and track **/
+  static Long64_t HitKey(Int_t VolId, Int_t TrackId)
+    {return (((Long64_t)VolId)<<32)|((UInt_t)TrackId);}
 
 private:
   hcalInf*  fInf;			//!
@@ -191,6 +195,9 @@ private:
   Int_t   fVolIdMax;			//!
   /** Number of first hit for current primary **/
   Int_t fFirstNumber;			//!
+  /** Index in fLiteCollection of the hits of the current primary,
+   ** keyed by HitKey(volume ID, track ID) **/
+  std::unordered_map<Long64_t, Int_t> fHitIndex;	//!
   /** Map of volumes in HCAL
    ** fVolArr[0]==code of sensivite wall
    ** fVolArr[4]==code of Lead
@@ -111,7 +111,9 @@ parser.add_argument("--phiRandom", help="only relevant for muon background gener
 parser.add_argument("--SmearBeam", dest="SmearBeam",  help="Standard deviation of beam smearing (muon background only) [cm]", default=0.8, type=float)
 parser.add_argument("--PaintBeam", dest="PaintBeam",  help="Radius of beam painting (muon background only) [cm]", default=5, type=float)
 parser.add_argument("--Cosmics", dest="cosmics", help="Use cosmic generator, argument switch for cosmic generator 0 or 1", default=None)  # TODO: Understand integer options, replace with store_true?
+parser.add_argument("--MuonBackIndex", dest="muonBackIndex", help="MuonBack: read only entries with muons, using a selection index (cached in this file if given)", nargs="?", const="", default=None)
 parser.add_argument("--MuDIS", dest="mudis", help="Use muon deep inelastic scattering generator", action="store_true")
+parser.add_argument("--ProfileBinWidth", dest="profileBinWidth", help="Genie/MuDIS: share material profiles of trajectories within this x, y grid [cm], 0 walks every trajectory", default=0., type=float)
 parser.add_argument("--RpvSusy", dest="RPVSUSY", help="Generate events based on RPV neutralino", action="store_true")
 parser.add_argument("--DarkPhoton", help="Generate dark photons", action="store_true")
 parser.add_argument("--SusyBench", dest="RPVSUSYbench", help="Generate HP Susy", default=2)
@@ -395,6 +397,7 @@ if simEngine == "muonDIS":
  mu_start, mu_end = ship_geo.Chamber1.z-ship_geo.chambers.Tub1length-10.*u.cm,ship_geo.TrackStation1.z
  print('MuDIS position info input=',mu_start, mu_end)
  DISgen.SetPositions(mu_start, mu_end)
+ DISgen.SetProfileBinWidth(options.profileBinWidth)
  DISgen.Init(inputFile,options.firstEvent)
  primGen.AddGenerator(DISgen)
  options.nEvents = min(options.nEvents,DISgen.GetNevents())
@@ -406,6 +409,7 @@ if simEngine == "Genie":
  primGen.SetTarget(0., 0.) # do not interfere with GenieGenerator
  Geniegen = ROOT.GenieGenerator()
  Geniegen.Init(inputFile,options.firstEvent)
+ Geniegen.SetProfileBinWidth(options.profileBinWidth)
  Geniegen.SetPositions(ship_geo.target.z0, ship_geo.tauMudet.zMudetC-5*u.m, ship_geo.TrackStation2.z)
  primGen.AddGenerator(Geniegen)
  options.nEvents = min(options.nEvents,Geniegen.GetNevents())
@@ -416,6 +420,7 @@ if simEngine == "nuRadiography":
  primGen.SetTarget(0., 0.) # do not interfere with GenieGenerator
  Geniegen = ROOT.GenieGenerator()
  Geniegen.Init(inputFile,options.firstEvent)
+ Geniegen.SetProfileBinWidth(options.profileBinWidth)
  # Geniegen.SetPositions(ship_geo.target.z0, ship_geo.target.z0, ship_geo.MuonStation3.z)
  Geniegen.SetPositions(ship_geo.target.z0, ship_geo.tauMudet.zMudetC, ship_geo.MuonStation3.z)
  Geniegen.NuOnly()
@@ -461,6 +466,7 @@ if simEngine == "MuonBack":
         print("MuonBackgenerator: set downscale for dimuon on")
     testf.Close()
  if options.sameSeed: MuonBackgen.SetSameSeed(options.sameSeed)
+ if options.muonBackIndex is not None: MuonBackgen.UseSelectionIndex(options.muonBackIndex)
  primGen.AddGenerator(MuonBackgen)
  options.nEvents = min(options.nEvents,MuonBackgen.GetNevents())
  MCTracksWithHitsOnly = True # otherwise, output file becomes too big
@@ -1,6 +1,7 @@
 #include "muon.h"
 
 #include "muonPoint.h"
+#include "muonStationPar.h"
 
 
 #include "FairVolume.h"
@@ -72,6 +73,13 @@ void muon::Initialize()
   FairDetector::Initialize();
 //  FairRuntimeDb* rtdb= FairRun::Instance()->GetRuntimeDb();
 //  muonGeoPar* par=(muonGeoPar*)(rtdb->getContainer("muonGeoPar"));
+  // station layout for the tile mapping of muonHit, saved with the run parameters
+  FairRuntimeDb* rtdb= FairRun::Instance()->GetRuntimeDb();
+  muonStationPar* par=(muonStationPar*)(rtdb->getContainer("muonStationPar"));
+  if (par && par->Fill(gGeoManager)) {
+    par->setChanged();
+    par->setInputVersion(FairRun::Instance()->GetRunId(),1);
+  }
 }
 // -----   Private method InitMedium
 Int_t muon::InitMedium(const char* name)
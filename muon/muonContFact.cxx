@@ -1,5 +1,6 @@
 #include "muonContFact.h"
 #include "FairRuntimeDb.h"
+#include "muonStationPar.h"
 
 #include <iostream>
 
@@ -30,6 +31,10 @@ void muonContFact::setAllContainers()
 
   containers->Add(p);
 */
+  FairContainer* p= new FairContainer("muonStationPar",
+                                      "Muon station layout",
+                                      "Default");
+  containers->Add(p);
  }
 
 FairParSet* muonContFact::createContainer(FairContainer* c)
@@ -47,5 +52,11 @@ FairParSet* muonContFact::createContainer(FairContainer* c)
      }
      return p;
    */
-    return 0;
+    const char* name=c->GetName();
+    FairParSet* p=NULL;
+    if (strcmp(name,"muonStationPar")==0) {
+      p=new muonStationPar(c->getConcatName().Data(),
+                           c->GetTitle(),c->getContext());
+    }
+    return p;
 }
@@ -0,0 +1,60 @@
+#include "muonDigitizer.h"
+
+#include "TClonesArray.h"
+#include "TVector3.h"
+#include "muonHit.h"
+#include "muonPoint.h"
+
+// -----   Default constructor   -------------------------------------------
+muonDigitizer::muonDigitizer(UInt_t seed)
+    : fRandom(seed)
+{}
+
+void muonDigitizer::SmearTimes(const Double_t* times, Double_t* smeared, Int_t n, Double_t sigma)
+{
+    for (Int_t i = 0; i < n; i++) {
+        smeared[i] = fRandom.Gaus(times[i], sigma);
+    }
+}
+
+void muonDigitizer::SmearTimes(const std::vector<Double_t>& times, std::vector<Double_t>& smeared, Double_t sigma)
+{
+    smeared.resize(times.size());
+    SmearTimes(times.data(), smeared.data(), times.size(), sigma);
+}
+
+// -----   Public method Exec   --------------------------------------------
+Int_t muonDigitizer::Exec(TClonesArray* points, Double_t t0, TClonesArray* hits)
+{
+    hits->Delete();
+    fDetID.clear();
+    fTime.clear();
+    fEarliest.clear();
+
+    muonHit mapping;
+    Int_t nPoints = points->GetEntriesFast();
+    for (Int_t i = 0; i < nPoints; i++) {
+        auto* p = static_cast<muonPoint*>(points->At(i));
+        fDetID.push_back(mapping.DetIDfromXYZ(TVector3(p->GetX(), p->GetY(), p->GetZ())));
+        // the tdc is stored as Float_t before smearing, as in muonHit(muonPoint*, t0)
+        Float_t tdc = t0 + p->GetTime();
+        fTime.push_back(tdc);
+    }
+    SmearTimes(fTime, fSmeared, muonHit::muonTimeResSigma);
+
+    for (Int_t i = 0; i < nPoints; i++) {
+        auto* hit = new ((*hits)[i]) muonHit(fDetID[i], fSmeared[i], kTRUE);
+        auto [it, inserted] = fEarliest.try_emplace(fDetID[i], i);
+        if (inserted) {
+            continue;
+        }
+        auto* first = static_cast<muonHit*>(hits->At(it->second));
+        if (first->GetDigi() > hit->GetDigi()) {
+            first->setValidity(kFALSE);
+            it->second = i;
+        } else {
+            hit->setValidity(kFALSE);
+        }
+    }
+    return nPoints;
+}
@@ -0,0 +1,43 @@
+#ifndef MUON_MUONDIGITIZER_H_
+#define MUON_MUONDIGITIZER_H_ 1
+
+#include "Rtypes.h"
+#include "TRandom3.h"
+
+#include <unordered_map>
+#include <vector>
+
+class TClonesArray;
+
+/**
+ ** Digitisation of all muonPoints of an event in one call. The digitiser owns the
+ ** random engine of the time smearing, seeded once, so that the hits are reproducible
+ ** and no generator is created per hit:
+ **  - tdc = t0 + point time, smeared with the muon time resolution for all points at once
+ **  - one muonHit per point, in point order, the hit with the smallest tdc of a tile is valid
+ **/
+class muonDigitizer
+{
+  public:
+    explicit muonDigitizer(UInt_t seed = 4357);
+    virtual ~muonDigitizer() = default;
+
+    void SetSeed(UInt_t seed) { fRandom.SetSeed(seed); }
+    TRandom& GetRandom() { return fRandom; }
+
+    /** smeared[i] = Gaus(times[i], sigma) for i < n, drawn in order **/
+    void SmearTimes(const Double_t* times, Double_t* smeared, Int_t n, Double_t sigma);
+    void SmearTimes(const std::vector<Double_t>& times, std::vector<Double_t>& smeared, Double_t sigma);
+
+    /** Fill hits with one muonHit per point, returns the number of hits **/
+    Int_t Exec(TClonesArray* points, Double_t t0, TClonesArray* hits);
+
+  private:
+    TRandom3 fRandom;
+    std::vector<Int_t> fDetID;
+    std::vector<Double_t> fTime;
+    std::vector<Double_t> fSmeared;
+    std::unordered_map<Int_t, Int_t> fEarliest;   ///< detID -> index of the valid hit, per event
+};
+
+#endif   // MUON_MUONDIGITIZER_H_
@@ -1,28 +1,24 @@
 #include "muonHit.h"
 #include "muonPoint.h"
+#include "muonStationPar.h"
 #include "TVector3.h"
 //
 #include "TGeoManager.h"
-#include "TGeoBBox.h"
+#include "TMath.h"
 
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <vector>
 
-#include "TRandom3.h"
+#include "TRandom.h"
 
 using std::cout;
 using std::endl;
 
-bool muonHit::onlyOnce=false;
-const Double_t tileXdim = 10., tileYdim = 20.; // single tile dimension
-const Double_t muonTimeResSigma = 0.5; // ns
-static std::vector<Int_t> tileXn, tileYn; // n. of tile along X and Y dimension
-static std::vector<Double_t> muStxMax;  // dX of the different stations
-static std::vector<Double_t> muStyMax;  // dY of the different stations
-static std::vector<Double_t> muStzMax;  // dZ of the different stations
-static std::vector<Double_t> muStZpos;  // global Z coord in diff. stations
+static const muonStationPar* muLayout = nullptr;  // layout set from the run parameters
+static muonStationPar* muGeoLayout = nullptr;     // layout built from the geometry
+static TGeoManager* muLayoutGeo = nullptr;        // geometry of muGeoLayout
 
 Double_t speedOfLight = TMath::C() *100./1000000000.0 ; // from m/sec to cm/ns
 // -----   Default constructor   -------------------------------------------
@@ -68,28 +64,8 @@ Int_t muonHit::DetIDfromXYZ(TVector3 p)
 //                                                           ---------------------------
 // negative detID means ERROR.
 //
-    Int_t detID, nStat; // unique detector ID, station number
-//
-  if (!onlyOnce) {
-    stInit();
-    onlyOnce = true;
-  }
-    nStat = -1;
-    for(Int_t i=0; i<muStZpos.size(); i++) {
-     if (abs(p.Z() - muStZpos[i]) <= muStzMax[i]) {
-       nStat = i;
-       break;
-     }
-    }
-//
-    if (nStat != -1) {
-      detID=(Int_t)((p.X()+muStxMax[nStat])/tileXdim)+tileXn[nStat]
-           *(Int_t)((p.Y()+muStyMax[nStat])/tileYdim)+10000*nStat;
-    } else {
-      detID = -1;
-    }
-//
-    return detID;
+    const muonStationPar* layout = GetStationLayout();
+    return layout ? layout->DetIDfromXYZ(p) : -1;
 }
 // ----
 TVector3 muonHit::XYZfromDetID(Int_t dID)
@@ -99,74 +75,35 @@ TVector3 muonHit::XYZfromDetID(Int_t dID)
 //
 // Negative Z coordinate means ERROR
 //
-    Int_t nStat; TVector3 p; // station number, center tile coordinate
-//
-  if (!onlyOnce) {
-    stInit();
-    onlyOnce = true;
-  }
-    nStat = -1;
-    for(Int_t i=0; i<=muStZpos.size(); i++) {
-      if (dID < 10000*i) {
-        nStat = i;
-        break;
-      }
-    }
-    if (nStat < 1) {// ERROR! dID too low (nStat=0) or too high (nStat=-1)
-      p.SetXYZ(-999999,-999999,-999999);
-      return p;
-    }
-
-//
-    p.SetZ(muStZpos[--nStat]); // now must be 0 <= nstat <= (n. of stations - 1)
-    dID -= 10000*(nStat);
-//
-    Int_t muXpos, muYpos;
-    muXpos = tileXdim*((dID%tileXn[nStat])+0.5)-muStxMax[nStat];
-    muYpos = tileYdim*((Int_t)(dID/tileXn[nStat])+0.5)-muStyMax[nStat];
-    p.SetXYZ(muXpos, muYpos, muStZpos[nStat]);
-//
-    return p;
-//
+    const muonStationPar* layout = GetStationLayout();
+    return layout ? layout->XYZfromDetID(dID) : TVector3(-999999,-999999,-999999);
 }
 // ----
-void muonHit::stInit()
+void muonHit::SetStationLayout(const muonStationPar* layout)
+{
+    muLayout = layout;
+}
+// ----
+const muonStationPar* muonHit::GetStationLayout()
 {
 //
+// stations are taken from the geometry only once, unless the geometry changes
 //
-    TGeoShape* muShape; TGeoBBox* muonBox;
-    TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
-    Double_t loc[3]={0,0,0}, global[3]={0,0,0};
-//
-    TString muDet = "cave/MuonDetector_1";
-    nav->cd(muDet);
-    TGeoNode* node = nav->GetCurrentNode();
-    TObjArray* nodes =  node->GetVolume()->GetNodes();
-//
-    for (Int_t i = 0; i < nodes->GetEntries(); i++) {
-      node = (TGeoNode*)nodes->At(i);
-      Int_t muStNs = 0;
-      if (TString(node->GetName()).Contains("muondet")) {
-        nav->cd(muDet+"/"+node->GetName());
-        TGeoVolume* volu = node->GetVolume();
-        muShape = node->GetVolume()->GetShape();
-        muonBox = (TGeoBBox*) muShape;
-        muStxMax.push_back(muonBox->GetDX()); muStyMax.push_back(muonBox->GetDY());
-        muStzMax.push_back(muonBox->GetDZ());
-        nav->LocalToMaster(loc,global); muStZpos.push_back(global[2]);
-        tileXn.push_back(2*muStxMax.at(muStNs)/tileXdim);
-        tileYn.push_back(2*muStyMax.at(muStNs)/tileYdim);
-	muStNs++; // muon stations increment
-      }
+    if (muLayout) return muLayout;
+    if (!gGeoManager) return nullptr;
+    if (!muGeoLayout || muLayoutGeo != gGeoManager) {
+      if (!muGeoLayout) muGeoLayout = new muonStationPar("muonStationPar","Muon station layout","Default");
+      muGeoLayout->Fill(gGeoManager);
+      muLayoutGeo = gGeoManager;
     }
+    return muGeoLayout;
 }
 // -------------------------------------------------------------------------
-Double_t muonHit::SetMuonTimeRes(Double_t mcTime) {
+Double_t muonHit::SetMuonTimeRes(Double_t mcTime, TRandom* rand) {
 //
-  TRandom3 *rand = new TRandom3(0);
-  Double_t cTime = rand->Gaus(mcTime,muonTimeResSigma);
-  delete rand;
-  return cTime;
+// long lived generator: the one of muonDigitizer, or gRandom
+  if (!rand) rand = gRandom;
+  return rand->Gaus(mcTime,muonTimeResSigma);
 }
 void muonHit::Print() const {
 //
@@ -7,6 +7,9 @@
 #include "ShipHit.h"
 #include "muonPoint.h"
 
+class TRandom;
+class muonStationPar;
+
 
 class muonHit : public ShipHit
 {
@@ -25,6 +28,10 @@ class muonHit : public ShipHit
 
     Int_t DetIDfromXYZ(TVector3 p); //provide mapping, true xyz to detectorID
     TVector3 XYZfromDetID(Int_t detID);  // return centre of muon tile
+    /** station layout of the mapping, from the run parameters, not owned; nullptr: from gGeoManager **/
+    static void SetStationLayout(const muonStationPar* layout);
+    /** layout in use, built from gGeoManager once per geometry if none was set **/
+    static const muonStationPar* GetStationLayout();
 /** Destructor **/
     virtual ~muonHit();
 
@@ -34,8 +41,10 @@ class muonHit : public ShipHit
     TVector3 getPos() {return XYZfromDetID(fDetectorID);}
     Bool_t isValid() const {return hisV;}
 //
-    Double_t SetMuonTimeRes(Double_t mcTime); // return tdc
+    /** return tdc smeared with the time resolution, drawn from rand or gRandom **/
+    Double_t SetMuonTimeRes(Double_t mcTime, TRandom* rand = nullptr);
     void setValidity(Bool_t isValid);
+    static constexpr Double_t muonTimeResSigma = 0.5; // ns
 //
   private:
     /** Copy constructor **/
@@ -44,9 +53,6 @@ class muonHit : public ShipHit
 
     Float_t flag;   ///< flag
 
-    static bool onlyOnce;
-    void stInit(); // stations init
-//
     Bool_t hisV;
 //
     ClassDef(muonHit,3)
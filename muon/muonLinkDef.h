@@ -8,5 +8,7 @@
 #pragma link C++ class muon+;
 #pragma link C++ class muonPoint+;
 #pragma link C++ class muonHit+;
+#pragma link C++ class muonDigitizer;
+#pragma link C++ class muonStationPar+;
 
 #endif
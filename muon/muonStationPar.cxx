@@ -0,0 +1,169 @@
+#include "muonStationPar.h"
+
+#include "FairParamList.h"
+#include "TGeoBBox.h"
+#include "TGeoManager.h"
+#include "TGeoNavigator.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TString.h"
+
+#include <algorithm>
+#include <numeric>
+
+// -----   Standard constructor   ------------------------------------------
+muonStationPar::muonStationPar(const char* name, const char* title, const char* context)
+    : FairParGenericSet(name, title, context)
+{}
+
+// -----   Default constructor   -------------------------------------------
+muonStationPar::muonStationPar()
+    : FairParGenericSet()
+{}
+
+void muonStationPar::clear()
+{
+    fXMax.Set(0);
+    fYMax.Set(0);
+    fDZ.Set(0);
+    fZPos.Set(0);
+    fTileXn.Set(0);
+    fTileYn.Set(0);
+    fZOrder.clear();
+    fZLow.clear();
+}
+
+// -----   Put parameters   ------------------------------------------------
+void muonStationPar::putParams(FairParamList* list)
+{
+    if (!list) {
+        return;
+    }
+    list->add("Station dx", fXMax, 6);
+    list->add("Station dy", fYMax, 6);
+    list->add("Station dz", fDZ, 6);
+    list->add("Station z", fZPos, 6);
+    list->add("Station tiles x", fTileXn);
+    list->add("Station tiles y", fTileYn);
+}
+
+// -----   Get parameters   ------------------------------------------------
+Bool_t muonStationPar::getParams(FairParamList* list)
+{
+    if (!list) {
+        return kFALSE;
+    }
+    if (!list->fill("Station dx", &fXMax) || !list->fill("Station dy", &fYMax) || !list->fill("Station dz", &fDZ)
+        || !list->fill("Station z", &fZPos) || !list->fill("Station tiles x", &fTileXn)
+        || !list->fill("Station tiles y", &fTileYn)) {
+        return kFALSE;
+    }
+    SortStations();
+    return kTRUE;
+}
+
+// -----   Public method Fill   --------------------------------------------
+Bool_t muonStationPar::Fill(TGeoManager* geo)
+{
+    clear();
+    if (!geo) {
+        return kFALSE;
+    }
+    TGeoNavigator* nav = geo->GetCurrentNavigator();
+    TString current = nav->GetPath();
+    TString muDet = "cave/MuonDetector_1";
+    if (!nav->cd(muDet)) {
+        return kFALSE;
+    }
+    TObjArray* nodes = nav->GetCurrentNode()->GetVolume()->GetNodes();
+    Double_t loc[3] = {0, 0, 0}, global[3] = {0, 0, 0};
+    std::vector<Double_t> dx, dy, dz, z;
+    for (Int_t i = 0; nodes && i < nodes->GetEntriesFast(); i++) {
+        auto* node = static_cast<TGeoNode*>(nodes->At(i));
+        if (!TString(node->GetName()).Contains("muondet")) {
+            continue;
+        }
+        nav->cd(muDet + "/" + node->GetName());
+        auto* box = static_cast<TGeoBBox*>(node->GetVolume()->GetShape());
+        nav->LocalToMaster(loc, global);
+        dx.push_back(box->GetDX());
+        dy.push_back(box->GetDY());
+        dz.push_back(box->GetDZ());
+        z.push_back(global[2]);
+    }
+    nav->cd(current);
+
+    Int_t n = z.size();
+    fXMax.Set(n, dx.data());
+    fYMax.Set(n, dy.data());
+    fDZ.Set(n, dz.data());
+    fZPos.Set(n, z.data());
+    fTileXn.Set(n);
+    fTileYn.Set(n);
+    for (Int_t i = 0; i < n; i++) {
+        fTileXn[i] = (Int_t)(2 * fXMax[i] / tileXdim);
+        fTileYn[i] = (Int_t)(2 * fYMax[i] / tileYdim);
+    }
+    SortStations();
+    return n > 0;
+}
+
+void muonStationPar::SortStations() const
+{
+    Int_t n = GetNStations();
+    fZOrder.resize(n);
+    std::iota(fZOrder.begin(), fZOrder.end(), 0);
+    std::stable_sort(fZOrder.begin(), fZOrder.end(), [this](Int_t a, Int_t b) {
+        return fZPos[a] - fDZ[a] < fZPos[b] - fDZ[b];
+    });
+    fZLow.resize(n);
+    for (Int_t k = 0; k < n; k++) {
+        fZLow[k] = fZPos[fZOrder[k]] - fDZ[fZOrder[k]];
+    }
+}
+
+Int_t muonStationPar::FindStation(Double_t z) const
+{
+    if ((Int_t)fZOrder.size() != GetNStations()) {
+        // streamed from the parameter file, the transient order is not there yet
+        SortStations();
+    }
+    // last station starting upstream of z, its neighbours cover touching faces and rounding
+    Int_t k = std::upper_bound(fZLow.begin(), fZLow.end(), z) - fZLow.begin();
+    Int_t station = -1;
+    for (Int_t j = std::max(k - 2, 0); j <= std::min(k, GetNStations() - 1); j++) {
+        Int_t i = fZOrder[j];
+        if (TMath::Abs(z - fZPos[i]) <= fDZ[i] && (station < 0 || i < station)) {
+            station = i;
+        }
+    }
+    return station;
+}
+
+Int_t muonStationPar::DetIDfromXYZ(const TVector3& p) const
+{
+    Int_t nStat = FindStation(p.Z());
+    if (nStat < 0) {
+        return -1;
+    }
+    return (Int_t)((p.X() + fXMax[nStat]) / tileXdim) + fTileXn[nStat] * (Int_t)((p.Y() + fYMax[nStat]) / tileYdim)
+           + 10000 * nStat;
+}
+
+TVector3 muonStationPar::XYZfromDetID(Int_t detID) const
+{
+    TVector3 p(-999999, -999999, -999999);
+    if (detID < 0 || detID >= 10000 * GetNStations()) {
+        return p;
+    }
+    Int_t nStat = detID / 10000;
+    Int_t tile = detID % 10000;
+    if (fTileXn[nStat] <= 0) {
+        return p;
+    }
+    // integer tile centre, as the former muonHit::XYZfromDetID
+    Int_t muXpos = tileXdim * ((tile % fTileXn[nStat]) + 0.5) - fXMax[nStat];
+    Int_t muYpos = tileYdim * ((Int_t)(tile / fTileXn[nStat]) + 0.5) - fYMax[nStat];
+    p.SetXYZ(muXpos, muYpos, fZPos[nStat]);
+    return p;
+}
@@ -0,0 +1,75 @@
+#ifndef MUON_MUONSTATIONPAR_H_
+#define MUON_MUONSTATIONPAR_H_ 1
+
+#include "FairParGenericSet.h"
+#include "TArrayD.h"
+#include "TArrayI.h"
+#include "TVector3.h"
+
+#include <vector>
+
+class FairParamList;
+class TGeoManager;
+
+/**
+ ** Layout of the muon stations, taken once from the muondet boxes of
+ ** cave/MuonDetector_1 and stored with the run parameters, so that the tile
+ ** mapping of muonHit does not need to navigate the geometry:
+ **  - per station half sizes, global z of the centre and number of tiles in x and y
+ **  - station of a z by binary search over the stations sorted in z
+ **  - tile of (x, y) and centre of a tile by arithmetic
+ ** Stations are numbered in the order of the geometry nodes, as the detector IDs.
+ **/
+class muonStationPar : public FairParGenericSet
+{
+  public:
+    static constexpr Double_t tileXdim = 10.;   ///< tile size in x [cm]
+    static constexpr Double_t tileYdim = 20.;   ///< tile size in y [cm]
+
+    muonStationPar(const char* name, const char* title, const char* context);
+    muonStationPar();
+    virtual ~muonStationPar() = default;
+
+    virtual void putParams(FairParamList* list);
+    virtual Bool_t getParams(FairParamList* list);
+    virtual void clear();
+
+    /** Fill the layout from the geometry, returns kFALSE if there is no muon detector **/
+    Bool_t Fill(TGeoManager* geo);
+
+    Int_t GetNStations() const { return fZPos.GetSize(); }
+    Double_t GetXMax(Int_t station) const { return fXMax[station]; }
+    Double_t GetYMax(Int_t station) const { return fYMax[station]; }
+    Double_t GetDZ(Int_t station) const { return fDZ[station]; }
+    Double_t GetZ(Int_t station) const { return fZPos[station]; }
+    Int_t GetTileXn(Int_t station) const { return fTileXn[station]; }
+    Int_t GetTileYn(Int_t station) const { return fTileYn[station]; }
+
+    /** station with |z - zStation| <= dz, the first in station order if two touch, -1 if none **/
+    Int_t FindStation(Double_t z) const;
+    /** detector ID of the tile at p, -1 outside the stations, numbering as in muonHit **/
+    Int_t DetIDfromXYZ(const TVector3& p) const;
+    /** centre of the tile, (-999999, -999999, -999999) for an invalid detector ID **/
+    TVector3 XYZfromDetID(Int_t detID) const;
+
+  private:
+    /** stations in increasing z, for FindStation; also rebuilt there after reading from a file **/
+    void SortStations() const;
+
+    TArrayD fXMax;    ///< half size in x of the stations
+    TArrayD fYMax;    ///< half size in y of the stations
+    TArrayD fDZ;      ///< half size in z of the stations
+    TArrayD fZPos;    ///< global z of the station centres
+    TArrayI fTileXn;  ///< number of tiles along x
+    TArrayI fTileYn;  ///< number of tiles along y
+
+    mutable std::vector<Int_t> fZOrder;   //! stations sorted by the z of their upstream face
+    mutable std::vector<Double_t> fZLow;  //! upstream face of the sorted stations
+
+    muonStationPar(const muonStationPar&);
+    muonStationPar& operator=(const muonStationPar&);
+
+    ClassDef(muonStationPar, 1)
+};
+
+#endif   // MUON_MUONSTATIONPAR_H_
@@ -79,7 +79,7 @@ class SciFiMapping:
                     "xpos": z.second[1],
                 }
 
-    def make_mapping(self):
+    def make_mapping(self, cache_file=None):
         """
         Execute the full mapping sequence for the SciFi detector.
 
@@ -87,7 +87,14 @@ class SciFiMapping:
         in the SciFi module, and build both fibre-to-SiPM and SiPM-to-fibre maps.
 
         Currently is used in python/shipDigiReco.py.
+
+        Parameters
+        ----------
+        cache_file : str, optional
+            ROOT file the SiPM mapping is read from, or written to if missing or outdated.
         """
+        if cache_file:
+            self.scifi.SetChannelMapCache(cache_file)
         self.scifi.SiPMOverlap()
         self.scifi.SiPMmapping()
         self.create_fibre_to_simp_map()
@@ -479,6 +479,9 @@ def configure(run, ship_geo):
     Muon.SetActiveThickness(ship_geo.Muon.ActiveThickness)
     Muon.SetFilterThickness(ship_geo.Muon.FilterThickness)
     detectorList.append(Muon)
+    # factory of muonStationPar, filled in muon::Initialize and saved with the run parameters
+    muonContFact = ROOT.muonContFact()
+    ROOT.SetOwnership(muonContFact, False)
 
     upstreamTagger = ROOT.UpstreamTagger("UpstreamTagger", ROOT.kTRUE)
     upstreamTagger.SetZposition(ship_geo.UpstreamTagger.Z_Position)
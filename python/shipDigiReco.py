@@ -83,15 +83,19 @@ class ShipDigiReco:
   #self.digiUpstreamTaggerBranch=self.sTree.Branch("Digi_UpstreamTaggerHits",self.digiUpstreamTagger,32000,-1)
   self.digiMuon    = ROOT.TClonesArray("muonHit")
   self.digiMuonBranch=self.sTree.Branch("Digi_muonHits",self.digiMuon,32000,-1)
+  self.muonDigitizer = ROOT.muonDigitizer()
+  self.muonStationPar = self.readMuonStationPar(fout)
 # for the digitizing step
   self.v_drift = global_variables.modules["Strawtubes"].StrawVdrift()
   self.sigma_spatial = global_variables.modules["Strawtubes"].StrawSigmaSpatial()
+  self.strawDigitizer = ROOT.strawtubesDigitizer(self.v_drift, self.sigma_spatial)
 # optional if present, splitcalCluster
   if self.sTree.GetBranch("splitcalPoint"):
    self.digiSplitcal = ROOT.TClonesArray("splitcalHit")
    self.digiSplitcalBranch=self.sTree.Branch("Digi_SplitcalHits",self.digiSplitcal,32000,-1)
    self.recoSplitcal = ROOT.TClonesArray("splitcalCluster")
    self.recoSplitcalBranch=self.sTree.Branch("Reco_SplitcalClusters",self.recoSplitcal,32000,-1)
+   self.splitcalClusterFinder = ROOT.splitcalClusterFinder()
 
 
   # add MTC module to the list of globals to use it later in the MTCDetHit class. Consistent with SND@LHC approach.
@@ -100,9 +104,12 @@ class ShipDigiReco:
     lsOfGlobals = ROOT.gROOT.GetListOfGlobals()
     if global_variables.modules["MTC"] not in lsOfGlobals:
       lsOfGlobals.Add(global_variables.modules["MTC"])
+    # plane transforms for the fibre and SiPM position queries, taken once from the geometry
+    global_variables.modules["MTC"].BuildTransformCache()
     mapping = SciFiMapping.SciFiMapping(global_variables.modules)
     mapping.make_mapping()
     self.sipm_to_fibre_map_U, self.sipm_to_fibre_map_V = mapping.get_sipm_to_fibre_map()
+    self.mtcDigitizer = ROOT.MtcDigitizer(global_variables.modules["MTC"])
 # setup ecal reconstruction
   self.caloTasks = []
   if self.sTree.GetBranch("EcalPoint") and not self.sTree.GetBranch("splitcalPoint"):
@@ -114,6 +121,7 @@ class ShipDigiReco:
    ecalFiller=ROOT.ecalStructureFiller("ecalFiller", dflag,ecalGeo)
    ecalFiller.SetUseMCPoints(ROOT.kTRUE)
    ecalFiller.StoreTrackInformation()
+   ecalFiller.UseTrackBuffer()
    self.caloTasks.append(ecalFiller)
  #GeV -> ADC conversion
    ecalDigi=ROOT.ecalDigi("ecalDigi",0)
@@ -279,6 +287,12 @@ class ShipDigiReco:
    # cluster reconstruction #
    ##########################
 
+   # done in C++ by splitcalClusterFinder, clusterSplitcalPython is the reference implementation
+   self.splitcalClusterFinder.Exec(self.digiSplitcal, self.recoSplitcal)
+
+ def clusterSplitcalPython(self):
+   # python reference of splitcalClusterFinder, gives the same clusters
+
    # hit selection
    # step 0: select hits above noise threshold to use in cluster reconstruction
    noise_energy_threshold = 0.002 #GeV
@@ -697,7 +711,26 @@ class ShipDigiReco:
      index+=1
 
 
+ def readMuonStationPar(self,fout):
+   """Muon station layout saved by the simulation in ship.params.<tag>.root, used for the tile mapping of muonHit.
+      Without it, muonHit takes the layout from the geometry."""
+   d, name = os.path.split(fout)
+   parFile = os.path.join(d, name.replace('ship.','ship.params.',1).replace('_rec.root','.root'))
+   if not os.path.isfile(parFile): return None
+   f = ROOT.TFile.Open(parFile)
+   par = f.Get("muonStationPar")
+   f.Close()
+   if not par or par.GetNStations() == 0:
+     print("no muon station layout in",parFile,", taken from the geometry")
+     return None
+   ROOT.muonHit.SetStationLayout(par)
+   return par
+
  def digitizeMuon(self):
+   """Digitize muon MC hits with muonDigitizer, the earliest hit per tile is valid."""
+   self.muonDigitizer.Exec(self.sTree.muonPoint, self.sTree.t0, self.digiMuon)
+
+ def digitizeMuon_python(self):
    index = 0
    hitsPerDetId = {}
    for aMCPoint in self.sTree.muonPoint:
@@ -714,6 +747,13 @@ class ShipDigiReco:
      index+=1
 
  def digitize_MTC(self):
+    """Digitize SND/MTC MC hits with MtcDigitizer, one MtcDetHit per SiPM channel or scint cell.
+
+    Same hits as digitize_MTC_python, which is kept as reference.
+    """
+    self.mtcDigitizer.Exec(self.sTree.MtcDetPoint, self.digiMTC)
+
+ def digitize_MTC_python(self):
     """Digitize SND/MTC MC hits.
 
     Example of fiberID: 123051820, where:
@@ -837,76 +877,26 @@ class ShipDigiReco:
 
     The earliest hit per straw will be marked valid, all later ones invalid.
     """
-    earliest_per_det_id = {}
-    for index, point in enumerate(self.sTree.strawtubesPoint):
-        hit = ROOT.strawtubesHit(point , self.sTree.t0)
-        self.digiStraw.push_back(hit)
-        if hit.isValid():
-            detector_id = hit.GetDetectorID()
-            if detector_id in earliest_per_det_id:
-               earliest = earliest_per_det_id[detector_id]
-               if self.digiStraw[earliest].GetTDC() > hit.GetTDC():
-                   # second hit with smaller tdc
-                   self.digiStraw[earliest].setInvalid()
-                   earliest_per_det_id[detector_id] = index
-               else:
-                   self.digiStraw[index].setInvalid()
-            else:
-                earliest_per_det_id[detector_id] = index
+    self.strawDigitizer.Digitize(self.sTree.strawtubesPoint, self.sTree.t0, self.digiStraw)
+
+ def smearedHitsFromDigitizer(self):
+  d = self.strawDigitizer
+  return [{'digiHit':key,'xtop':xtop,'ytop':ytop,'z':z,'xbot':xbot,'ybot':ybot,'dist':dist,'detID':detID}
+          for key,xtop,ytop,z,xbot,ybot,dist,detID in zip(d.GetDigiHit(),d.GetXtop(),d.GetYtop(),d.GetZ(),
+                                                           d.GetXbot(),d.GetYbot(),d.GetDist(),d.GetDetID())]
 
  def withT0Estimate(self):
- # loop over all straw tdcs and make average, correct for ToF
-  n = 0
-  t0 = 0.
-  key = -1
-  SmearedHits = []
-  v_drift = global_variables.modules["Strawtubes"].StrawVdrift()
-  global_variables.modules["Strawtubes"].StrawEndPoints(1002001, start, stop)
-  z1 = stop.z()
-  for aDigi in self.digiStraw:
-    key+=1
-    if not aDigi.isValid(): continue
-    detID = aDigi.GetDetectorID()
-    global_variables.modules["Strawtubes"].StrawEndPoints(detID, start, stop)
-    delt1 = (start[2]-z1)/u.speedOfLight
-    t0+=aDigi.GetDigi()-delt1
-    SmearedHits.append( {'digiHit':key,'xtop':stop.x(),'ytop':stop.y(),'z':stop.z(),'xbot':start.x(),'ybot':start.y(),'dist':aDigi.GetDigi(), 'detID':detID} )
-    n+=1
-  if n>0: t0 = t0/n - 73.2*u.ns
-  for s in SmearedHits:
-    delt1 = (s['z']-z1)/u.speedOfLight
-    s['dist'] = (s['dist'] -delt1 -t0)*v_drift
-  return SmearedHits
+ # average of all straw tdcs, corrected for ToF
+  self.strawDigitizer.SmearHitsWithT0Estimate(self.digiStraw)
+  return self.smearedHitsFromDigitizer()
 
  def smearHits(self,no_amb=None):
  # smear strawtube points
-  SmearedHits = []
-  key = -1
-  v_drift = global_variables.modules["Strawtubes"].StrawVdrift()
-  global_variables.modules["Strawtubes"].StrawEndPoints(1002001, start, stop)
-  z1 = stop.z()
-  for aDigi in self.digiStraw:
-     key+=1
-     if not aDigi.isValid(): continue
-     detID = aDigi.GetDetectorID()
-     global_variables.modules["Strawtubes"].StrawEndPoints(detID, start, stop)
-   #distance to wire
-     delt1 = (start[2]-z1)/u.speedOfLight
-     p=self.sTree.strawtubesPoint[key]
-     # use true t0  construction:
-     #     fdigi = t0 + p->GetTime() + t_drift + ( stop[0]-p->GetX() )/ speedOfLight;
-     smear = (aDigi.GetDigi() - self.sTree.t0  - p.GetTime() - ( stop[0]-p.GetX() )/ u.speedOfLight) * v_drift
-     if no_amb: smear = p.dist2Wire()
-     SmearedHits.append( {'digiHit':key,'xtop':stop.x(),'ytop':stop.y(),'z':stop.z(),'xbot':start.x(),'ybot':start.y(),'dist':smear, 'detID':detID} )
-     # Note: top.z()==bot.z() unless misaligned, so only add key 'z' to smearedHit
-     if abs(stop.y()) == abs(start.y()):
-       global_variables.h['disty'].Fill(smear)
-     elif abs(stop.y()) > abs(start.y()):
-       global_variables.h['distu'].Fill(smear)
-     elif abs(stop.y()) < abs(start.y()):
-       global_variables.h['distv'].Fill(smear)
-
-  return SmearedHits
+  h = global_variables.h
+  if 'disty' in h and 'distu' in h and 'distv' in h:
+    self.strawDigitizer.SetDistHistograms(h['disty'], h['distu'], h['distv'])
+  self.strawDigitizer.SmearHits(self.sTree.strawtubesPoint, self.digiStraw, self.sTree.t0, bool(no_amb))
+  return self.smearedHitsFromDigitizer()
 
  def findTracks(self):
   hitPosLists    = {}
@@ -1,6 +1,7 @@
 __author__ = 'Mikhail Hushchyn'
 
 import numpy as np
+import ROOT
 import global_variables
 
 # Globals
@@ -29,10 +30,13 @@ def execute(smeared_hits, ship_geo, method=''):
 
     recognized_tracks = {}
 
+    # TemplateMatching and FH run in C++ (strawtubesPatRec), without limit on the number of hits.
+    # template_matching_pattern_recognition and fast_hough_transform_pattern_recognition are the
+    # python reference implementations, they give the same tracks.
     if method == "TemplateMatching":
-        recognized_tracks = template_matching_pattern_recognition(smeared_hits, ship_geo)
+        recognized_tracks = compiled_pattern_recognition(smeared_hits, ship_geo, ROOT.strawtubesPatRec.kTemplateMatching)
     elif method == "FH":
-        recognized_tracks = fast_hough_transform_pattern_recognition(smeared_hits, ship_geo)
+        recognized_tracks = compiled_pattern_recognition(smeared_hits, ship_geo, ROOT.strawtubesPatRec.kFastHough)
     elif method == "AR":
         recognized_tracks = artificial_retina_pattern_recognition(smeared_hits, ship_geo)
     else:
@@ -48,6 +52,38 @@ def execute(smeared_hits, ship_geo, method=''):
 def finalize():
     pass
 
+
+_pat_rec = None
+
+def compiled_pattern_recognition(SmearedHits, ShipGeo, method):
+    """
+    Template matching or fast Hough transform pattern recognition with strawtubesPatRec.
+
+    Parameters:
+    -----------
+    SmearedHits : list
+        Smeared hits, as for execute.
+    method : int
+        strawtubesPatRec.kTemplateMatching or strawtubesPatRec.kFastHough
+    """
+
+    global _pat_rec
+    if _pat_rec is None:
+        _pat_rec = ROOT.strawtubesPatRec()
+        _pat_rec.SetStrawLength(max_x)
+
+    _pat_rec.ClearHits()
+    for ahit in SmearedHits:
+        _pat_rec.AddHit(ahit['digiHit'], ahit['detID'], ahit['xtop'], ahit['ytop'], ahit['z'], ahit['xbot'], ahit['ybot'])
+
+    recognized_tracks = {}
+    views = ['y12', 'stereo12', 'y34', 'stereo34']
+    for i_track in range(_pat_rec.Execute(method, ShipGeo.Bfield.z)):
+        recognized_tracks[i_track] = {view: [SmearedHits[i] for i in _pat_rec.GetTrackHits(i_track, i_view)]
+                                      for i_view, view in enumerate(views)}
+
+    return recognized_tracks
+
 ########################################################################################################################
 ##
 ## Template Matching
@@ -835,7 +871,7 @@ def reduce_clones_using_one_track_per_hit(recognized_tracks, min_hits=3):
     tracks_no_clones = []
     n_hits = [len(atrack['hits_y']) for atrack in recognized_tracks]
 
-    for i_track in np.argsort(n_hits)[::-1]:
+    for i_track in np.argsort(n_hits, kind='stable')[::-1]:
 
         atrack = recognized_tracks[i_track]
         new_track = {}
@@ -880,7 +916,7 @@ def tracks_combination_using_extrapolation(recognized_tracks_12, recognized_trac
     used_y12 = []
     used_y34 = []
 
-    for i in np.argsort(deltas_y):
+    for i in np.argsort(deltas_y, kind='stable'):
 
         dy = deltas_y[i]
         i_12 = i_track_y12[i]
@@ -0,0 +1,87 @@
+#!/usr/bin/env python
+import unittest
+import os
+
+try:
+    import ROOT
+    haveEcal = bool(os.environ.get("VMCWORKDIR")) and hasattr(ROOT, "ecalStructure")
+except ImportError:
+    haveEcal = False
+
+
+@unittest.skipUnless(haveEcal, "needs the FairShip ecal library and VMCWORKDIR")
+class TestTrackDepositBuffer(unittest.TestCase):
+    """track maps filled from the deposit buffer, as ecalStructureFiller.UseTrackBuffer and ecalMatch use them"""
+
+    def setUp(self):
+        inf = ROOT.ecalInf.GetInstance("ecal_ellipse5x10m2.geo")
+        self.str = ROOT.ecalStructure(inf)
+        self.str.SetUseMC(1)
+        self.str.Construct()
+        self.cell = self.str.GetCellArray()[0]
+        self.index = self.str.GetCellIndex(self.cell.GetCellNumber())
+
+    def event(self, deposits):
+        # as ecalStructureFiller::Exec followed by ecalMatch::Exec
+        self.str.ResetModules()
+        for track, energy, time in deposits:
+            self.str.AddEnergy(self.cell.GetCenterX(), self.cell.GetCenterY(), energy)
+            self.str.AddTrackDeposit(self.index, track, energy, time)
+        self.str.FillTrackMaps()
+        return ROOT.BindObject(ROOT.addressof(self.cell), ROOT.ecalCellMC)
+
+    def test_merge(self):
+        mc = self.event([(3, 0.25, 2.0), (3, 0.5, 1.0), (4, 0.125, -1111)])
+        self.assertEqual(mc.TrackEnergySize(), 2)
+        self.assertAlmostEqual(mc.GetTrackEnergy(3), 0.75)
+        self.assertAlmostEqual(mc.GetTrackTime(3), 1.0)
+        self.assertAlmostEqual(mc.GetTrackEnergy(4), 0.125)
+
+    def test_second_event(self):
+        self.event([(3, 0.25, 1.0)])
+        mc = self.event([(7, 0.5, 1.0)])
+        # the maps of the first event are gone and the second event is filled
+        self.assertEqual(mc.TrackEnergySize(), 1)
+        self.assertAlmostEqual(mc.GetTrackEnergy(7), 0.5)
+        self.assertAlmostEqual(self.cell.GetEnergy(), 0.5)
+        self.assertEqual(self.str.GetTrackDeposits().size(), 1)
+
+
+@unittest.skipUnless(haveEcal, "needs the FairShip ecal library and VMCWORKDIR")
+class TestActiveCellChain(unittest.TestCase):
+    """filler, ecalDigi, ecalPrepare and ecalMaximumLocator as in shipDigiReco"""
+
+    def setUp(self):
+        inf = ROOT.ecalInf.GetInstance("ecal_ellipse5x10m2.geo")
+        self.str = ROOT.ecalStructure(inf)
+        self.str.Construct()
+        self.cell = self.str.GetCellArray()[0]
+
+    def chain(self, zeroSuppression):
+        digi = ROOT.ecalDigi("ecalDigi", 0)
+        digi.InitPython(self.str)
+        digi.SetZeroSuppression(zeroSuppression)
+        prepare = ROOT.ecalPrepare("ecalPrepare", 0)
+        prepare.InitPython(self.str)
+        finder = ROOT.ecalMaximumLocator("maximumFinder", 0)
+        maximums = finder.InitPython(self.str)
+        for event in range(2):
+            self.str.ResetModules()
+            self.str.AddEnergy(self.cell.GetCenterX(), self.cell.GetCenterY(), 1.0)
+            for task in (digi, prepare, finder):
+                task.Exec("")
+            self.assertEqual(maximums.GetEntriesFast(), 1)
+            self.assertAlmostEqual(self.cell.GetEnergy(), 1.0, delta=0.05)
+        return self.str.IsAllTouched()
+
+    def test_zero_suppressed(self):
+        # only the active cells are digitized, reset stays on the active cells
+        self.assertFalse(self.chain(True))
+
+    def test_default(self):
+        # the default chain digitizes every cell, the next reset is a full one
+        self.assertTrue(self.chain(False))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+import unittest
+import math
+from types import SimpleNamespace
+
+import global_variables
+
+global_variables.ShipGeo = SimpleNamespace(
+    strawtubes=SimpleNamespace(StrawLength=250.0), Bfield=SimpleNamespace(z=3000.0)
+)
+try:
+    import ROOT
+    import shipPatRec
+
+    havePatRec = hasattr(ROOT, "strawtubesPatRec") and hasattr(ROOT, "strawtubes")
+except ImportError:
+    havePatRec = False
+
+VIEWS = ["y12", "stereo12", "y34", "stereo34"]
+STATION_Z = {1: 2500.0, 2: 2700.0, 3: 3300.0, 4: 3500.0}
+STEREO = {0: 0.0, 1: math.tan(5 * math.pi / 180), 2: -math.tan(5 * math.pi / 180), 3: 0.0}
+
+
+def make_hits():
+    """two straight tracks through all stations, views and layers, and a few noise hits"""
+    tracks = [
+        (lambda z: 0.01 * (z - 2500) + 10, lambda z: -0.02 * (z - 2500) + 30),
+        (lambda z: -0.015 * (z - 2500) - 40, lambda z: 0.01 * (z - 2500) - 50),
+    ]
+    points = []
+    for station, z0 in STATION_Z.items():
+        for view in range(4):
+            for layer in range(2):
+                z = z0 + 10 * view + layer
+                for y, x in tracks:
+                    points.append((station, view, layer, z, x(z), y(z)))
+    # noise, away from the tracks
+    points += [(1, 0, 0, 2500.0, 0.0, 90.0), (2, 3, 1, 2731.0, 0.0, -90.0), (3, 1, 0, 3310.0, 100.0, 60.0)]
+    hits = []
+    for i, (station, view, layer, z, x, y) in enumerate(points):
+        y += 0.05 * ((7 * i) % 5 - 2)   # fixed smearing
+        t = STEREO[view]
+        straw = 150 + int(math.floor(y / 2))
+        hits.append(
+            {
+                "digiHit": i,
+                "detID": station * 1000000 + view * 100000 + layer * 10000 + 2000 + straw,
+                "xtop": 250.0, "ytop": y + t * (250.0 - x), "z": z,
+                "xbot": -250.0, "ybot": y + t * (-250.0 - x),
+                "dist": 0.0,
+            }
+        )
+    return hits
+
+
+@unittest.skipUnless(havePatRec, "needs the FairShip strawtubes library and shipPatRec")
+class TestCompiledPatRec(unittest.TestCase):
+    """strawtubesPatRec against the python reference of shipPatRec on a fixed hit list"""
+
+    def setUp(self):
+        global_variables.modules = {"Strawtubes": ROOT.strawtubes}
+        self.hits = make_hits()
+
+    def compare(self, method, reference):
+        expected = reference(make_hits(), global_variables.ShipGeo)
+        found = shipPatRec.compiled_pattern_recognition(self.hits, global_variables.ShipGeo, method)
+        self.assertEqual(len(found), 2)
+        self.assertEqual(len(found), len(expected))
+        for i in expected:
+            for view in VIEWS:
+                self.assertEqual(
+                    [h["digiHit"] for h in found[i][view]],
+                    [h["digiHit"] for h in expected[i][view]],
+                    f"track {i}, view {view}",
+                )
+
+    def test_template_matching(self):
+        self.compare(ROOT.strawtubesPatRec.kTemplateMatching, shipPatRec.template_matching_pattern_recognition)
+
+    def test_fast_hough(self):
+        self.compare(ROOT.strawtubesPatRec.kFastHough, shipPatRec.fast_hough_transform_pattern_recognition)
+
+
+if __name__ == "__main__":
+    unittest.main()
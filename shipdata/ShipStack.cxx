@@ -18,11 +18,11 @@
 #include "TRefArray.h"                  // for TRefArray
 
 #include <stddef.h>                     // for NULL
+#include <algorithm>                    // for max
 #include <iostream>                     // for operator<<, etc
 
 using std::cout;
 using std::endl;
-using std::pair;
 
 
 // -----   Default constructor   -------------------------------------------
@@ -32,9 +32,7 @@ ShipStack::ShipStack(Int_t size)
     fParticles(new TClonesArray("TParticle", size)),
     fTracks(new TClonesArray("ShipMCTrack", size)),
     fStoreMap(),
-    fStoreIter(),
     fIndexMap(),
-    fIndexIter(),
     fPointsMap(),
     fCurrentTrack(-1),
     fNPrimaries(0),
@@ -227,8 +225,10 @@ void ShipStack::FillTrackArray()
 
   LOG(DEBUG) << "ShipStack: Filling MCTrack array...";
 
-  // --> Reset index map and number of output tracks
-  fIndexMap.clear();
+  // --> Reset index map and number of output tracks,
+  // --> with the entry for primary mothers first
+  fIndexMap.assign(fNParticles + 1, -2);
+  fIndexMap[0] = -1;
   fNTracks = 0;
 
   // --> Check tracks for selection criteria
@@ -237,29 +237,19 @@ void ShipStack::FillTrackArray()
   // --> Loop over fParticles array and copy selected tracks
   for (Int_t iPart=0; iPart<fNParticles; iPart++) {
 
-    fStoreIter = fStoreMap.find(iPart);
-    if (fStoreIter == fStoreMap.end() ) {
-      LOGF(fatal, "ShipStack: Particle %i not found in storage map! ", iPart);
-    }
-    Bool_t store = (*fStoreIter).second;
-
-    if (store) {
+    if (fStoreMap[iPart]) {
       ShipMCTrack* track =
         new( (*fTracks)[fNTracks]) ShipMCTrack(GetParticle(iPart));
-      fIndexMap[iPart] = fNTracks;
+      fIndexMap[iPart + 1] = fNTracks;
       // --> Set the number of points in the detectors for this track
       for (Int_t iDet=kVETO; iDet<kEndOfList; iDet++) {
-        pair<Int_t, Int_t> a(iPart, iDet);
-        track->SetNPoints(iDet, fPointsMap[a]);
+        track->SetNPoints(iDet, GetNPoints(iPart, iDet));
       }
       fNTracks++;
-    } else { fIndexMap[iPart] = -2; }
+    }
 
   }
 
-  // --> Map index for primary mothers
-  fIndexMap[-1] = -1;
-
   // --> Screen output
   //Print(1);
 
@@ -278,12 +268,7 @@ void ShipStack::UpdateTrackIndex(TRefArray* detList)
   // First update mother ID in MCTracks
   for (Int_t i=0; i<fNTracks; i++) {
     ShipMCTrack* track = (ShipMCTrack*)fTracks->At(i);
-    Int_t iMotherOld = track->GetMotherId();
-    fIndexIter = fIndexMap.find(iMotherOld);
-    if (fIndexIter == fIndexMap.end()) {
-      LOGF(fatal, "ShipStack: Particle index %i not found in dex map! ", iMotherOld);
-    }
-    track->SetMotherId( (*fIndexIter).second );
+    track->SetMotherId( GetTrackIndex(track->GetMotherId()) );
   }
 
 
@@ -309,14 +294,9 @@ void ShipStack::UpdateTrackIndex(TRefArray* detList)
       // --> Update track index for all MCPoints in the collection
       for (Int_t iPoint=0; iPoint<nPoints; iPoint++) {
         FairMCPoint* point = (FairMCPoint*)hitArray->At(iPoint);
-        Int_t iTrack = point->GetTrackID();
-
-        fIndexIter = fIndexMap.find(iTrack);
-        if (fIndexIter == fIndexMap.end()) {
-          LOGF(fatal, "ShipStack: Particle index %i not found in index map! ", iTrack);
-        }
-        point->SetTrackID((*fIndexIter).second);
-        point->SetLink(FairLink("MCTrack", (*fIndexIter).second));
+        Int_t iTrack = GetTrackIndex(point->GetTrackID());
+        point->SetTrackID(iTrack);
+        point->SetLink(FairLink("MCTrack", iTrack));
       }
 
     }   // Collections of this detector
@@ -336,6 +316,7 @@ void ShipStack::Reset()
   while (! fStack.empty() ) { fStack.pop(); }
   fParticles->Clear();
   fTracks->Clear();
+  // --> clear() keeps the capacity for the next event
   fPointsMap.clear();
 }
 // -------------------------------------------------------------------------
@@ -373,11 +354,7 @@ void ShipStack::Print(Int_t iVerbose) const
 // -----   Public method AddPoint (for current track)   --------------------
 void ShipStack::AddPoint(DetectorId detId)
 {
-  Int_t iDet = detId;
-// cout << "Add point for Detektor" << iDet << endl;
-  pair<Int_t, Int_t> a(fCurrentTrack, iDet);
-  if ( fPointsMap.find(a) == fPointsMap.end() ) { fPointsMap[a] = 1; }
-  else { fPointsMap[a]++; }
+  AddPoint(detId, fCurrentTrack);
 }
 // -------------------------------------------------------------------------
 
@@ -387,10 +364,13 @@ void ShipStack::AddPoint(DetectorId detId)
 void ShipStack::AddPoint(DetectorId detId, Int_t iTrack)
 {
   if ( iTrack < 0 ) { return; }
-  Int_t iDet = detId;
-  pair<Int_t, Int_t> a(iTrack, iDet);
-  if ( fPointsMap.find(a) == fPointsMap.end() ) { fPointsMap[a] = 1; }
-  else { fPointsMap[a]++; }
+  size_t i = static_cast<size_t>(iTrack) * kEndOfList + detId;
+  if ( i >= fPointsMap.size() ) {
+    // --> Grow by whole tracks, at least to the number of particles
+    size_t nTracks = std::max(iTrack + 1, fNParticles);
+    fPointsMap.resize(nTracks * kEndOfList, 0);
+  }
+  fPointsMap[i]++;
 }
 // -------------------------------------------------------------------------
 
@@ -420,12 +400,24 @@ TParticle* ShipStack::GetParticle(Int_t trackID) const
 
 
 
+// -----   Private method GetTrackIndex   ----------------------------------
+Int_t ShipStack::GetTrackIndex(Int_t iPart) const
+{
+  if (iPart < -1 || iPart + 1 >= static_cast<Int_t>(fIndexMap.size())) {
+    LOGF(fatal, "ShipStack: Particle index %i not found in index map! ", iPart);
+  }
+  return fIndexMap[iPart + 1];
+}
+// -------------------------------------------------------------------------
+
+
+
 // -----   Private method SelectTracks   -----------------------------------
 void ShipStack::SelectTracks()
 {
 
   // --> Clear storage map
-  fStoreMap.clear();
+  fStoreMap.assign(fNParticles, kTRUE);
 
   // --> Check particles in the fParticle array
   for (Int_t i=0; i<fNParticles; i++) {
@@ -445,10 +437,7 @@ void ShipStack::SelectTracks()
     // --> Calculate number of points
     Int_t nPoints = 0;
     for (Int_t iDet=kVETO; iDet<kEndOfList; iDet++) {
-      pair<Int_t, Int_t> a(i, iDet);
-      if ( fPointsMap.find(a) != fPointsMap.end() ) {
-        nPoints += fPointsMap[a];
-      }
+      nPoints += GetNPoints(i, iDet);
     }
 
     // --> Check for cuts (store primaries in any case)
@@ -476,8 +465,11 @@ void ShipStack::SelectTracks()
 	{
           while(iMother >= 0)
 	  {
+            // a stored mother already visited in this loop has its own mothers flagged
+            if (iMother < i && fStoreMap[iMother]) { break; }
+            TParticle* mother = GetParticle(iMother);
             fStoreMap[iMother] = kTRUE;
-            iMother = GetParticle(iMother)->GetMother(0);
+            iMother = mother->GetMother(0);
           }
        }
       }
@@ -32,9 +32,8 @@
 #include "Rtypes.h"                     // for Int_t, Double_t, Bool_t, etc
 #include "TMCProcess.h"                 // for TMCProcess
 
-#include <map>                          // for map, map<>::iterator
 #include <stack>                        // for stack
-#include <utility>                      // for pair
+#include <vector>                       // for vector
 
 class TClonesArray;
 class TParticle;
@@ -210,18 +209,20 @@ class ShipStack : public FairGenericStack
     TClonesArray* fTracks;
 
 
-    /** STL map from particle index to storage flag  **/
-    std::map<Int_t, Bool_t>           fStoreMap;        //!
-    std::map<Int_t, Bool_t>::iterator fStoreIter;       //!
+    /** Storage flag, indexed by particle index  **/
+    std::vector<Bool_t>  fStoreMap;        //!
 
 
-    /** STL map from particle index to track index  **/
-    std::map<Int_t, Int_t>            fIndexMap;        //!
-    std::map<Int_t, Int_t>::iterator  fIndexIter;       //!
+    /** Output track index, indexed by particle index + 1 (the first entry
+     ** maps the mother index -1 of primaries)
+     **/
+    std::vector<Int_t>   fIndexMap;        //!
 
 
-    /** STL map from track index and detector ID to number of MCPoints **/
-    std::map<std::pair<Int_t, Int_t>, Int_t> fPointsMap;     //!
+    /** Number of MCPoints, indexed by track index * kEndOfList + detector ID.
+     ** The vectors keep their capacity between events.
+     **/
+    std::vector<Int_t>   fPointsMap;       //!
 
 
     /** Some indizes and counters **/
@@ -242,10 +243,22 @@ class ShipStack : public FairGenericStack
     /** Mark tracks for output using selection criteria  **/
     void SelectTracks();
 
+    /** Output track index for a particle index (-1 for primary mothers),
+     ** fatal if the index is not in the map
+     **/
+    Int_t GetTrackIndex(Int_t iPart) const;
+
+    /** Number of MCPoints of a track in a given detector **/
+    Int_t GetNPoints(Int_t iTrack, Int_t iDet) const
+    {
+      size_t i = static_cast<size_t>(iTrack) * kEndOfList + iDet;
+      return i < fPointsMap.size() ? fPointsMap[i] : 0;
+    }
+
     ShipStack(const ShipStack&);
     ShipStack& operator=(const ShipStack&);
 
-    ClassDef(ShipStack,1)
+    ClassDef(ShipStack,2)
 
 
 };
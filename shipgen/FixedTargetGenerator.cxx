@@ -7,6 +7,7 @@
 #include "TGeoVolume.h"
 #include <TGeoManager.h>
 #include "TGeoBBox.h"
+#include "TH1.h"
 #include "TMath.h"
 #include "FixedTargetGenerator.h"
 #include "HNLPythia8Generator.h"
@@ -17,7 +18,6 @@
 
 const Double_t cm = 10.; // pythia units are mm
 const Double_t c_light = 2.99792458e+10; // speed of light in cm/sec (c_light   = 2.99792458e+8 * m/s)
-const Double_t mbarn = 1E-3*1E-24*TMath::Na(); // cm^2 * Avogadro
 
 // -----   Default constructor   -------------------------------------------
 FixedTargetGenerator::FixedTargetGenerator()
@@ -220,7 +220,6 @@ Bool_t FixedTargetGenerator::Init()
    }
   }
   if (targetName!=""){
-   fMaterialInvestigator = new GenieGenerator();
    TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
    nav->cd(targetName);
    TGeoNode* target = nav->GetCurrentNode();
@@ -248,7 +247,8 @@ Bool_t FixedTargetGenerator::Init()
    end[1]=yOff;
    end[2]=endZ;
 //find maximum interaction length
-   bparam = fMaterialInvestigator->MeanMaterialBudget(start, end, mparam);
+   fMaterialProfile.Fill(start, end);
+   bparam = fMaterialProfile.MeanMaterialBudget(mparam);
    maxCrossSection =  mparam[9];
   }
 
@@ -270,41 +270,13 @@ Bool_t FixedTargetGenerator::ReadEvent(FairPrimaryGenerator* cpg)
   Double_t ZoverA = 1.;
   if (targetName.Data() !=""){
 // calculate primary proton interaction point:
-// loop over trajectory between start and end to pick an interaction point, copied from GenieGenerator and adapted to hadrons
-   Double_t prob2int = -1.;
-   Double_t rndm = 0.;
-   Double_t sigma;
-   Int_t count=0;
-   Double_t zinterStart = start[2];
-   if (Option == "charm" || Option == "beauty"){
-// simulate more downstream interaction points for interactions down in the cascade
-    if (!(nTree->GetBranch("k"))){ck=1;}
-   }
-   else {ck=1;}
-   while (ck>0.5){
-    while (prob2int<rndm) {
- //place x,y,z uniform along path
-      zinter = gRandom->Uniform(zinterStart,end[2]);
-      Double_t point[3]={xOff,yOff,zinter};
-      bparam = fMaterialInvestigator->MeanMaterialBudget(start, point, mparam);
-      Double_t interLength = mparam[8];
-      TGeoNode *node = gGeoManager->FindNode(point[0],point[1],point[2]);
-      TGeoMaterial *mat = 0;
-      if (node && !gGeoManager->IsOutside()) {
-         mat = node->GetVolume()->GetMaterial();
-         Double_t n = mat->GetDensity()/mat->GetA();
-         ZoverA =  mat->GetZ() / mat->GetA();
-         sigma = 1./(n*mat->GetIntLen())/mbarn;
-         prob2int = TMath::Exp(-interLength)*sigma/maxCrossSection;
-      }else{
-         prob2int=0.;
-      }
-      rndm = gRandom->Uniform(0.,1.);
-      count+=1;
-    }
-    zinterStart = zinter;
-    ck-=1;
-  }
+// draw it along the trajectory between start and end from the material profile of the target,
+// with probability sigma*exp(-interaction length from start)
+// for charm and beauty, the interactions down in the cascade (ck) are placed at the same point
+   Double_t u = fMaterialProfile.SampleInteraction(0., 1., gRandom->Uniform(0.,1.));
+   zinter = start[2] + u*(end[2]-start[2]);
+   const MaterialProfile::Segment* seg = fMaterialProfile.SegmentAt(u);
+   if (seg) {ZoverA = seg->Z / seg->A;}
   zinter = zinter*cm;
   }
   Pythia8::Pythia* fPythia;
@@ -7,7 +7,7 @@
 #include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
 #include "TTree.h"
 #include "TNtuple.h"
-#include "GenieGenerator.h"
+#include "MaterialBudgetSampler.h"
 
 class FairPrimaryGenerator;
 class EvtGenDecays;
@@ -69,7 +69,7 @@ class FixedTargetGenerator : public FairGenerator
   Pythia8::Pythia* fPythiaP;            //!
   EvtGenDecays* evtgenN;            //!
   EvtGenDecays* evtgenP;            //!
-  GenieGenerator* fMaterialInvestigator;  //!
+  MaterialProfile fMaterialProfile;  //!
   Bool_t withNtuple;               //! special option for Dark Photon physics studies
   TNtuple* fNtuple;               //!
   TString targetName,Option;
@@ -84,150 +84,11 @@ Double_t GenieGenerator::MeanMaterialBudget(const Double_t *start, const Double_
   // mparam[8] - equivalent interaction length fraction: sum(x_i/I0_i) [adimensional]
   // mparam[9] - maximum cross section encountered (mbarn)
   //
-  //  Origin:  Marian Ivanov, Marian.Ivanov@cern.ch
+  // The geometry walk is done by MaterialProfile::Fill.
   //
-  //  Corrections and improvements by
-  //        Andrea Dainese, Andrea.Dainese@lnl.infn.it,
-  //        Andrei Gheata,  Andrei.Gheata@cern.ch
-  //        Thomas Ruf,  Thomas.Ruf@cern.ch
-  //
-
-  mparam[0]=0; mparam[1]=1; mparam[2]=0; mparam[3]=0; mparam[4]=0;
-  mparam[5]=0; mparam[6]=0; mparam[7]=0; mparam[8]=0; mparam[9]=0;
-  //
-  Double_t bparam[7]; // total parameters
-  Double_t lparam[7]; // local parameters
-  Double_t mbarn = 1E-3*1E-24*TMath::Na(); // cm^2 * Avogadro
-
-  for (Int_t i=0;i<7;i++) bparam[i]=0;
-
-  if (!gGeoManager) {
-    //AliFatalClass("No TGeo\n");
-    return 0.;
-  }
-  //
-  Double_t length;
-  Double_t dir[3];
-  length = TMath::Sqrt((end[0]-start[0])*(end[0]-start[0])+
-                       (end[1]-start[1])*(end[1]-start[1])+
-                       (end[2]-start[2])*(end[2]-start[2]));
-  mparam[4]=length;
-  if (length<TGeoShape::Tolerance()) return 0.0;
-  Double_t invlen = 1./length;
-  dir[0] = (end[0]-start[0])*invlen;
-  dir[1] = (end[1]-start[1])*invlen;
-  dir[2] = (end[2]-start[2])*invlen;
-
-  // Initialize start point and direction
-  TGeoNode *currentnode = 0;
-  TGeoNode *startnode = gGeoManager->InitTrack(start, dir);
-  if (!startnode) {
-    //AliErrorClass(Form("start point out of geometry: x %f, y %f, z %f",
-    //		  start[0],start[1],start[2]));
-    return 0.0;
-  }
-  TGeoMaterial *material = startnode->GetVolume()->GetMedium()->GetMaterial();
-  lparam[0]   = material->GetDensity();
-  if (lparam[0] > mparam[7]) mparam[7]=lparam[0];
-  lparam[1]   = material->GetRadLen();
-  lparam[2]   = material->GetA();
-  lparam[3]   = material->GetZ();
-  lparam[4]   = length;
-  lparam[5]   = lparam[3]/lparam[2];
-  lparam[6]   = material->GetIntLen();
-  Double_t  n = lparam[0]/lparam[2];
-  Double_t  sigma = 1./(n*lparam[6])/mbarn;
-  if (sigma > mparam[9]) mparam[9]=sigma;
-  if (material->IsMixture()) {
-    TGeoMixture * mixture = (TGeoMixture*)material;
-    lparam[5] =0;
-    Double_t sum =0;
-    for (Int_t iel=0;iel<mixture->GetNelements();iel++){
-      sum  += mixture->GetWmixt()[iel];
-      lparam[5]+= mixture->GetZmixt()[iel]*mixture->GetWmixt()[iel]/mixture->GetAmixt()[iel];
-    }
-    lparam[5]/=sum;
-  }
-
-  // Locate next boundary within length without computing safety.
-  // Propagate either with length (if no boundary found) or just cross boundary
-  gGeoManager->FindNextBoundaryAndStep(length, kFALSE);
-  Double_t step = 0.0; // Step made
-  Double_t snext = gGeoManager->GetStep();
-  // If no boundary within proposed length, return current density
-  if (!gGeoManager->IsOnBoundary()) {
-    mparam[0] = lparam[0];
-    mparam[1] = lparam[4]/lparam[1];
-    mparam[2] = lparam[2];
-    mparam[3] = lparam[3];
-    mparam[4] = lparam[4];
-    mparam[8] = lparam[4]/lparam[6];
-    return lparam[0];
-  }
-  // Try to cross the boundary and see what is next
-  Int_t nzero = 0;
-  while (length>TGeoShape::Tolerance()) {
-    currentnode = gGeoManager->GetCurrentNode();
-    if (snext<2.*TGeoShape::Tolerance()) nzero++;
-    else nzero = 0;
-    if (nzero>3) {
-      // This means navigation has problems on one boundary
-      // Try to cross by making a small step
-      //AliErrorClass("Cannot cross boundary\n");
-      mparam[0] = bparam[0]/step;
-      mparam[1] = bparam[1];
-      mparam[2] = bparam[2]/step;
-      mparam[3] = bparam[3]/step;
-      mparam[5] = bparam[5]/step;
-      mparam[8] = bparam[6];
-      mparam[4] = step;
-      mparam[0] = 0.;             // if crash of navigation take mean density 0
-      mparam[1] = 1000000;        // and infinite rad length
-      return bparam[0]/step;
-    }
-    mparam[6]+=1.;
-    step += snext;
-    bparam[1]    += snext/lparam[1];
-    bparam[2]    += snext*lparam[2];
-    bparam[3]    += snext*lparam[3];
-    bparam[5]    += snext*lparam[5];
-    bparam[6]    += snext/lparam[6];
-    bparam[0]    += snext*lparam[0];
-
-    if (snext>=length) break;
-    if (!currentnode) break;
-    length -= snext;
-    material = currentnode->GetVolume()->GetMedium()->GetMaterial();
-    lparam[0] = material->GetDensity();
-    if (lparam[0] > mparam[7]) mparam[7]=lparam[0];
-    lparam[1]  = material->GetRadLen();
-    lparam[2]  = material->GetA();
-    lparam[3]  = material->GetZ();
-    lparam[5]   = lparam[3]/lparam[2];
-    lparam[6]   = material->GetIntLen();
-    n = lparam[0]/lparam[2];
-    sigma = 1./(n*lparam[6])/mbarn;
-    if (sigma > mparam[9]) mparam[9]=sigma;
-    if (material->IsMixture()) {
-      TGeoMixture * mixture = (TGeoMixture*)material;
-      lparam[5]=0;
-      Double_t sum =0;
-      for (Int_t iel=0;iel<mixture->GetNelements();iel++){
-        sum+= mixture->GetWmixt()[iel];
-        lparam[5]+= mixture->GetZmixt()[iel]*mixture->GetWmixt()[iel]/mixture->GetAmixt()[iel];
-      }
-      lparam[5]/=sum;
-    }
-    gGeoManager->FindNextBoundaryAndStep(length, kFALSE);
-    snext = gGeoManager->GetStep();
-  }
-  mparam[0] = bparam[0]/step;
-  mparam[1] = bparam[1];
-  mparam[2] = bparam[2]/step;
-  mparam[3] = bparam[3]/step;
-  mparam[5] = bparam[5]/step;
-  mparam[8] = bparam[6];
-  return bparam[0]/step;
+  MaterialProfile profile;
+  profile.Fill(start, end);
+  return profile.MeanMaterialBudget(mparam);
 }
 
 std::vector<double> GenieGenerator::Rotate(Double_t x, Double_t y, Double_t z, Double_t px, Double_t py, Double_t pz)
@@ -409,7 +270,7 @@ Bool_t GenieGenerator::ReadEvent(FairPrimaryGenerator* cpg)
     if (fFirst){
       Double_t bparam=0.;
       Double_t mparam[10];
-      bparam=MeanMaterialBudget(start, end, mparam);
+      bparam=fMaterialSampler.Profile(start, end).MeanMaterialBudget(mparam);
       cout << "Info GenieGenerator: MaterialBudget " << start[2] << " - "<< end[2] <<  endl;
       cout << "Info GenieGenerator: MaterialBudget " << bparam <<  endl;
       cout << "Info GenieGenerator: MaterialBudget 0 " << mparam[0] <<  endl;
@@ -461,6 +322,7 @@ Bool_t GenieGenerator::ReadEvent(FairPrimaryGenerator* cpg)
     //cout << "Info GenieGenerator: ztarget " << ztarget << endl;
     Double_t bparam=0.;
     Double_t mparam[10];
+    const MaterialProfile* profile = nullptr;
     Double_t pout[3];
     pout[2]=-1.;
     Double_t txnu=0;
@@ -508,41 +370,16 @@ Bool_t GenieGenerator::ReadEvent(FairPrimaryGenerator* cpg)
         end[1]=tynu*(end[2]-ztarget);
         //cout << "Info GenieGenerator: neutrino xyz-end " << end[0] << "-" << end[1] << "-" << end[2] << endl;
         //get material density between these two points
-        bparam=MeanMaterialBudget(start, end, mparam);
+        profile = &fMaterialSampler.Profile(start, end);
+        bparam = profile->MeanMaterialBudget(mparam);
         //printf("param %e %e %e \n",bparam,mparam[6],mparam[7]);
        }
     }
-    //loop over trajectory between start and end to pick an interaction point
-    Double_t prob2int = -1.;
-    Double_t x;
-    Double_t y;
-    Double_t z;
-    Int_t count=0;
-    while (prob2int<gRandom->Uniform(0.,1.)) {
-      //place x,y,z uniform along path
-      z=gRandom->Uniform(start[2],end[2]);
-      x=txnu*(z-ztarget);
-      y=tynu*(z-ztarget);
-      if (mparam[6]<0.5){
-        //mparam is number of boundaries along path. mparam[6]=0.: uniform material budget along path, use present x,y,z
-        prob2int=2.;
-      }else{
-        //get local material at this point, to calculate probability that interaction is at this point.
-        TGeoNode *node = gGeoManager->FindNode(x,y,z);
-        TGeoMaterial *mat = 0;
-        if (node && !gGeoManager->IsOutside()) {
-          mat = node->GetVolume()->GetMaterial();
-         //cout << "Info GenieGenerator: mat " <<  count << ", " << mat->GetName() << ", " << mat->GetDensity() << endl;
-         //density relative to Prob largest density along this trajectory, i.e. use rho(Pt)
-         prob2int= mat->GetDensity()/mparam[7];
-         if (prob2int>1.) cout << "***WARNING*** GenieGenerator: prob2int > Maximum density????" << prob2int << " maxrho:" << mparam[7] << " material: " <<  mat->GetName() << endl;
-         count+=1;
-        }else{
-          prob2int=0.;
-        }
-     }
-    }
-    //cout << "Info GenieGenerator: prob2int " << prob2int << ", " << count << endl;
+    //pick an interaction point along the trajectory, with probability proportional to the local density
+    Double_t u = profile->SampleDensity(gRandom->Uniform(0.,1.));
+    Double_t z = start[2] + u*(end[2]-start[2]);
+    Double_t x = txnu*(z-ztarget);
+    Double_t y = tynu*(z-ztarget);
 
     Double_t zrelative=z-ztarget;
     Double_t tof = TMath::Sqrt(x * x + y * y + zrelative * zrelative) / 2.99792458e+10;   // speed of light in cm/s
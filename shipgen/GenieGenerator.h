@@ -9,6 +9,7 @@
 #include "TH2.h"                        // for TH2
 #include "TVector3.h"
 #include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
+#include "MaterialBudgetSampler.h"
 #include "vector"
 
 class FairPrimaryGenerator;
@@ -36,6 +37,8 @@ class GenieGenerator : public FairGenerator
     endZ        = zE;
   }
   void AddBox(TVector3 dVec, TVector3 box);
+  // share material profiles between neutrino trajectories within this x,y grid at startZ and endZ (cm), 0: exact
+  void SetProfileBinWidth(Double_t w){fMaterialSampler.SetBinWidth(w);}
   Double_t MeanMaterialBudget(const Double_t *start, const Double_t *end, Double_t *mparam);
  private:
   std::vector<double> Rotate(Double_t x, Double_t y, Double_t z, Double_t px, Double_t py, Double_t pz);
@@ -61,6 +64,7 @@ class GenieGenerator : public FairGenerator
   Double_t fEntrDz_inner,fEntrDz_outer,fEntrZ_inner,fEntrZ_outer,fEntrA,fEntrB,fL1z,fScintDz;
   TH1D* pxhist[3000];//!
   TH1D* pyslice[3000][100];//!
+  MaterialBudgetSampler fMaterialSampler;//!
 
   ClassDef(GenieGenerator,1);
 };
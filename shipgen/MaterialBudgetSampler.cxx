@@ -0,0 +1,308 @@
+#include "MaterialBudgetSampler.h"
+
+#include "TGeoManager.h"
+#include "TGeoMaterial.h"
+#include "TGeoMedium.h"
+#include "TGeoNode.h"
+#include "TGeoShape.h"
+#include "TGeoVolume.h"
+#include "TMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const Double_t mbarn = 1E-3 * 1E-24 * TMath::Na();   // cm^2 * Avogadro
+
+Double_t ZOverA(TGeoMaterial* material)
+{
+    if (!material->IsMixture()) {
+        return material->GetZ() / material->GetA();
+    }
+    TGeoMixture* mixture = static_cast<TGeoMixture*>(material);
+    Double_t zoa = 0;
+    Double_t sum = 0;
+    for (Int_t iel = 0; iel < mixture->GetNelements(); iel++) {
+        sum += mixture->GetWmixt()[iel];
+        zoa += mixture->GetZmixt()[iel] * mixture->GetWmixt()[iel] / mixture->GetAmixt()[iel];
+    }
+    return zoa / sum;
+}
+
+Double_t CrossSection(TGeoMaterial* material)
+{
+    Double_t n = material->GetDensity() / material->GetA();
+    Double_t intLen = material->GetIntLen();
+    if (n <= 0. || intLen <= 0.) {
+        return 0.;
+    }
+    return 1. / (n * intLen) / mbarn;
+}
+}   // namespace
+
+// -----   MaterialProfile   -----------------------------------------------
+MaterialProfile::MaterialProfile()
+    : fSegments()
+    , fLength(0.)
+    , fMeanDensity(0.)
+    , fParams{0, 1, 0, 0, 0, 0, 0, 0, 0, 0}
+{}
+
+Bool_t MaterialProfile::Fill(const Double_t* start, const Double_t* end)
+{
+    // Same walk as the original MeanMaterialBudget (M. Ivanov, A. Dainese,
+    // A. Gheata, T. Ruf), additionally recording every material segment.
+    fSegments.clear();
+    fParams = {0, 1, 0, 0, 0, 0, 0, 0, 0, 0};
+    fMeanDensity = 0.;
+    fLength = 0.;
+    Double_t* mparam = fParams.data();
+    Double_t bparam[7] = {0, 0, 0, 0, 0, 0, 0};   // total parameters
+
+    if (!gGeoManager) {
+        return kFALSE;
+    }
+    Double_t length = TMath::Sqrt((end[0] - start[0]) * (end[0] - start[0]) + (end[1] - start[1]) * (end[1] - start[1])
+                                  + (end[2] - start[2]) * (end[2] - start[2]));
+    fLength = length;
+    mparam[4] = length;
+    if (length < TGeoShape::Tolerance()) {
+        return kTRUE;
+    }
+    Double_t invlen = 1. / length;
+    Double_t dir[3] = {
+        (end[0] - start[0]) * invlen, (end[1] - start[1]) * invlen, (end[2] - start[2]) * invlen};
+
+    TGeoNode* startnode = gGeoManager->InitTrack(start, dir);
+    if (!startnode) {
+        return kFALSE;
+    }
+    TGeoMaterial* material = startnode->GetVolume()->GetMedium()->GetMaterial();
+    Segment current{};
+    auto setMaterial = [&](TGeoMaterial* mat) {
+        current.density = mat->GetDensity();
+        current.A = mat->GetA();
+        current.Z = mat->GetZ();
+        current.intLen = mat->GetIntLen();
+        current.sigma = CrossSection(mat);
+        if (current.density > mparam[7])
+            mparam[7] = current.density;
+        if (current.sigma > mparam[9])
+            mparam[9] = current.sigma;
+    };
+    setMaterial(material);
+    Double_t radLen = material->GetRadLen();
+    Double_t zoa = ZOverA(material);
+
+    // Locate next boundary within length without computing safety.
+    // Propagate either with length (if no boundary found) or just cross boundary
+    gGeoManager->FindNextBoundaryAndStep(length, kFALSE);
+    Double_t step = 0.0;   // Step made
+    Double_t snext = gGeoManager->GetStep();
+    // If no boundary within proposed length, the whole path is one material
+    if (!gGeoManager->IsOnBoundary()) {
+        current.sBegin = 0.;
+        current.sEnd = length;
+        fSegments.push_back(current);
+        mparam[0] = current.density;
+        mparam[1] = length / radLen;
+        mparam[2] = current.A;
+        mparam[3] = current.Z;
+        mparam[4] = length;
+        mparam[8] = length / current.intLen;
+        fMeanDensity = current.density;
+        return kTRUE;
+    }
+    // Try to cross the boundary and see what is next
+    Int_t nzero = 0;
+    while (length > TGeoShape::Tolerance()) {
+        TGeoNode* currentnode = gGeoManager->GetCurrentNode();
+        if (snext < 2. * TGeoShape::Tolerance())
+            nzero++;
+        else
+            nzero = 0;
+        if (nzero > 3) {
+            // This means navigation has problems on one boundary
+            mparam[2] = bparam[2] / step;
+            mparam[3] = bparam[3] / step;
+            mparam[5] = bparam[5] / step;
+            mparam[8] = bparam[6];
+            mparam[4] = step;
+            mparam[0] = 0.;        // if crash of navigation take mean density 0
+            mparam[1] = 1000000;   // and infinite rad length
+            fMeanDensity = bparam[0] / step;
+            return kTRUE;
+        }
+        mparam[6] += 1.;
+        if (snext > 0.) {
+            current.sBegin = step;
+            current.sEnd = step + snext;
+            current.rhoBegin = bparam[0];
+            current.lambdaBegin = bparam[6];
+            fSegments.push_back(current);
+        }
+        step += snext;
+        bparam[1] += snext / radLen;
+        bparam[2] += snext * current.A;
+        bparam[3] += snext * current.Z;
+        bparam[5] += snext * zoa;
+        bparam[6] += snext / current.intLen;
+        bparam[0] += snext * current.density;
+
+        if (snext >= length)
+            break;
+        if (!currentnode)
+            break;
+        length -= snext;
+        material = currentnode->GetVolume()->GetMedium()->GetMaterial();
+        setMaterial(material);
+        radLen = material->GetRadLen();
+        zoa = ZOverA(material);
+        gGeoManager->FindNextBoundaryAndStep(length, kFALSE);
+        snext = gGeoManager->GetStep();
+    }
+    mparam[0] = bparam[0] / step;
+    mparam[1] = bparam[1];
+    mparam[2] = bparam[2] / step;
+    mparam[3] = bparam[3] / step;
+    mparam[5] = bparam[5] / step;
+    mparam[8] = bparam[6];
+    fMeanDensity = bparam[0] / step;
+    return kTRUE;
+}
+
+Double_t MaterialProfile::MeanMaterialBudget(Double_t* mparam) const
+{
+    std::copy(fParams.begin(), fParams.end(), mparam);
+    return fMeanDensity;
+}
+
+Double_t MaterialProfile::SampleDensity(Double_t rndm) const
+{
+    if (fSegments.empty() || fLength <= 0.) {
+        return rndm;
+    }
+    const Segment& last = fSegments.back();
+    Double_t total = last.rhoBegin + last.density * (last.sEnd - last.sBegin);
+    if (total <= 0.) {
+        return rndm;
+    }
+    Double_t target = rndm * total;
+    // last segment starting at or below target, the integral is flat over empty segments
+    auto it = std::upper_bound(fSegments.begin(), fSegments.end(), target, [](Double_t t, const Segment& seg) {
+        return t < seg.rhoBegin;
+    });
+    const Segment& seg = *(it == fSegments.begin() ? it : it - 1);
+    Double_t s = seg.sBegin;
+    if (seg.density > 0.) {
+        s = std::min(seg.sBegin + (target - seg.rhoBegin) / seg.density, seg.sEnd);
+    }
+    return s / fLength;
+}
+
+Double_t MaterialProfile::InteractionWeight(const Segment& seg, Double_t s, Double_t f) const
+{
+    if (seg.sigma <= 0. || seg.intLen <= 0. || s >= seg.sEnd) {
+        return 0.;
+    }
+    if (f <= 0.) {
+        return seg.sigma * (seg.sEnd - s);
+    }
+    // integral of sigma * exp(-f * lambda) from s to sEnd, lambda grows by 1/intLen per cm
+    Double_t lambda = seg.lambdaBegin + (s - seg.sBegin) / seg.intLen;
+    Double_t scale = seg.sigma * seg.intLen / f * std::exp(-f * lambda);
+    return -scale * std::expm1(-f * (seg.sEnd - s) / seg.intLen);
+}
+
+Double_t MaterialProfile::SampleInteraction(Double_t uMin, Double_t lengthFactor, Double_t rndm) const
+{
+    if (fSegments.empty() || fLength <= 0.) {
+        return uMin + rndm * (1. - uMin);
+    }
+    Double_t sMin = uMin * fLength;
+    std::vector<Double_t> weights(fSegments.size());
+    Double_t total = 0.;
+    for (size_t i = 0; i < fSegments.size(); i++) {
+        weights[i] = InteractionWeight(fSegments[i], std::max(sMin, fSegments[i].sBegin), lengthFactor);
+        total += weights[i];
+    }
+    if (total <= 0.) {
+        return uMin + rndm * (1. - uMin);
+    }
+    Double_t target = rndm * total;
+    size_t i = 0;
+    size_t lastUsed = 0;
+    for (; i < fSegments.size(); i++) {
+        if (weights[i] <= 0.)
+            continue;
+        lastUsed = i;
+        if (target < weights[i])
+            break;
+        target -= weights[i];
+    }
+    if (i == fSegments.size()) {
+        // rounding left target beyond the total, take the end of the last segment
+        return fSegments[lastUsed].sEnd / fLength;
+    }
+    const Segment& seg = fSegments[i];
+    Double_t a = std::max(sMin, seg.sBegin);
+    Double_t t = 0.;
+    if (lengthFactor <= 0.) {
+        t = target / seg.sigma;
+    } else {
+        Double_t lambda = seg.lambdaBegin + (a - seg.sBegin) / seg.intLen;
+        Double_t scale = seg.sigma * seg.intLen / lengthFactor * std::exp(-lengthFactor * lambda);
+        t = -seg.intLen / lengthFactor * std::log1p(-std::min(target / scale, 1.));
+    }
+    Double_t s = std::min(a + t, seg.sEnd);
+    return s / fLength;
+}
+
+const MaterialProfile::Segment* MaterialProfile::SegmentAt(Double_t u) const
+{
+    Double_t s = u * fLength;
+    auto it = std::upper_bound(
+        fSegments.begin(), fSegments.end(), s, [](Double_t x, const Segment& seg) { return x < seg.sEnd; });
+    if (it == fSegments.end()) {
+        // the end point itself belongs to the last segment
+        if (!fSegments.empty() && s <= fSegments.back().sEnd && s >= fSegments.back().sBegin) {
+            return &fSegments.back();
+        }
+        return nullptr;
+    }
+    if (s < it->sBegin) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+// -----   MaterialBudgetSampler   -----------------------------------------
+MaterialBudgetSampler::MaterialBudgetSampler()
+    : fBinWidth(0.)
+    , fMaxEntries(100000)
+    , fCache()
+    , fScratch()
+{}
+
+const MaterialProfile& MaterialBudgetSampler::Profile(const Double_t* start, const Double_t* end)
+{
+    if (fBinWidth <= 0.) {
+        // exact trajectories are hardly ever repeated, do not cache them
+        fScratch.Fill(start, end);
+        return fScratch;
+    }
+    std::array<Double_t, 6> key = {start[0], start[1], start[2], end[0], end[1], end[2]};
+    for (Int_t i : {0, 1, 3, 4}) {
+        key[i] = std::round(key[i] / fBinWidth) * fBinWidth;
+    }
+    auto it = fCache.find(key);
+    if (it != fCache.end()) {
+        return *it->second;
+    }
+    if (fCache.size() >= fMaxEntries) {
+        fCache.clear();
+    }
+    auto profile = std::make_unique<MaterialProfile>();
+    profile->Fill(key.data(), key.data() + 3);
+    return *fCache.emplace(key, std::move(profile)).first->second;
+}
@@ -0,0 +1,98 @@
+#ifndef SHIPGEN_MATERIALBUDGETSAMPLER_H_
+#define SHIPGEN_MATERIALBUDGETSAMPLER_H_ 1
+
+#include "Rtypes.h"
+
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Material profile along a straight trajectory, filled with one geometry walk.
+// The path is stored as consecutive segments of constant material, with the
+// integrated density and interaction length up to the start of each segment,
+// so that interaction points can be drawn by inverting the cumulative
+// distribution instead of navigating the geometry for every trial point.
+// Positions along the path are given as the fraction u in [0, 1] of the
+// distance from start to end.
+class MaterialProfile
+{
+  public:
+    struct Segment
+    {
+        Double_t sBegin;     // path length at the start of the segment [cm]
+        Double_t sEnd;       // path length at the end of the segment [cm]
+        Double_t density;    // [g/cm3]
+        Double_t A;          // [g/mole]
+        Double_t Z;          //
+        Double_t intLen;     // nuclear interaction length [cm]
+        Double_t sigma;      // cross section 1/(n*intLen) [mbarn], 0 for empty segments
+        Double_t rhoBegin;   // integrated density up to sBegin [g/cm2]
+        Double_t lambdaBegin;   // interaction length fraction up to sBegin
+    };
+
+    MaterialProfile();
+
+    // Walk the geometry from start to end. Returns false if there is no geometry
+    // or the start point is outside of it, the profile is then empty.
+    Bool_t Fill(const Double_t* start, const Double_t* end);
+
+    // Mean material budget and material properties of the whole path, see
+    // GenieGenerator::MeanMaterialBudget for the meaning of mparam[0..9].
+    // Returns the mean density.
+    Double_t MeanMaterialBudget(Double_t* mparam) const;
+
+    // Draw a point with probability proportional to the local density, from a
+    // uniform random number rndm in [0, 1). A path without any material is
+    // sampled uniformly.
+    Double_t SampleDensity(Double_t rndm) const;
+
+    // Draw a point beyond uMin with probability proportional to
+    // sigma(u) * exp(-lengthFactor * lambda(u)), where lambda(u) is the interaction
+    // length fraction between start and u, from a uniform random number rndm in [0, 1).
+    // This is the distribution of the hadron interaction point in the target.
+    Double_t SampleInteraction(Double_t uMin, Double_t lengthFactor, Double_t rndm) const;
+
+    // Segment containing u, or nullptr if u is outside of the walked path
+    const Segment* SegmentAt(Double_t u) const;
+
+    Double_t GetLength() const { return fLength; }
+    const std::vector<Segment>& GetSegments() const { return fSegments; }
+
+  private:
+    // weight of sigma * exp(-f * lambda) between s and segment end
+    Double_t InteractionWeight(const Segment& seg, Double_t s, Double_t f) const;
+
+    std::vector<Segment> fSegments;
+    Double_t fLength;             // distance from start to end [cm]
+    Double_t fMeanDensity;        // return value of MeanMaterialBudget
+    std::array<Double_t, 10> fParams;   // mparam of the whole path
+};
+
+// Cache of material profiles for generators that draw interaction points along
+// many trajectories. With a bin width of 0 (the default) nothing is cached, every
+// trajectory is walked once into a scratch profile. With a bin width > 0 the start and end
+// points are rounded to that grid in x and y, all trajectories of a bin share the
+// profile of the rounded trajectory, and the sampled fraction u is then applied
+// to the actual trajectory.
+class MaterialBudgetSampler
+{
+  public:
+    MaterialBudgetSampler();
+
+    void SetBinWidth(Double_t width) { fBinWidth = width; }
+    void SetMaxEntries(size_t n) { fMaxEntries = n; }
+    void Clear() { fCache.clear(); }
+
+    // Profile for the trajectory from start to end, filled on first use.
+    // The reference is valid until the next call.
+    const MaterialProfile& Profile(const Double_t* start, const Double_t* end);
+
+  private:
+    Double_t fBinWidth;
+    size_t fMaxEntries;
+    std::map<std::array<Double_t, 6>, std::unique_ptr<MaterialProfile>> fCache;
+    MaterialProfile fScratch;   // profile of the last trajectory without binning
+};
+
+#endif   // SHIPGEN_MATERIALBUDGETSAMPLER_H_
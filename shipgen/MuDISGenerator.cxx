@@ -53,168 +53,6 @@ Bool_t MuDISGenerator::Init(const char* fileName, const int firstEvent)
     return kTRUE;
 }
 
-Double_t MuDISGenerator::MeanMaterialBudget(const Double_t* start, const Double_t* end, Double_t* mparam)
-{
-    //
-    // Calculate mean material budget and material properties between
-    //    the points "start" and "end".
-    //
-    // "mparam" - parameters used for the energy and multiple scattering
-    //  corrections:
-    //
-    // mparam[0] - mean density: sum(x_i*rho_i)/sum(x_i) [g/cm3]
-    // mparam[1] - equivalent rad length fraction: sum(x_i/X0_i) [adimensional]
-    // mparam[2] - mean A: sum(x_i*A_i)/sum(x_i) [adimensional]
-    // mparam[3] - mean Z: sum(x_i*Z_i)/sum(x_i) [adimensional]
-    // mparam[4] - length: sum(x_i) [cm]
-    // mparam[5] - Z/A mean: sum(x_i*Z_i/A_i)/sum(x_i) [adimensional]
-    // mparam[6] - number of boundary crosses
-    // mparam[7] - maximum density encountered (g/cm^3)
-    //
-    //  Origin:  Marian Ivanov, Marian.Ivanov@cern.ch
-    //
-    //  Corrections and improvements by
-    //        Andrea Dainese, Andrea.Dainese@lnl.infn.it,
-    //        Andrei Gheata,  Andrei.Gheata@cern.ch
-    //        Anupama Reghunath, anupama.reghunath@cern.ch
-    //
-
-    mparam[0] = 0;
-    mparam[1] = 1;
-    mparam[2] = 0;
-    mparam[3] = 0;
-    mparam[4] = 0;
-    mparam[5] = 0;
-    mparam[6] = 0;
-    mparam[7] = 0;
-    //
-    Double_t bparam[6];   // total parameters
-    Double_t lparam[6];   // local parameters
-
-    for (Int_t i = 0; i < 6; i++)
-        bparam[i] = 0;
-
-    if (!gGeoManager) {
-        return 0.;
-    }
-    //
-    Double_t length;
-    Double_t dir[3];
-    length = TMath::Sqrt((end[0] - start[0]) * (end[0] - start[0]) + (end[1] - start[1]) * (end[1] - start[1])
-                         + (end[2] - start[2]) * (end[2] - start[2]));
-    mparam[4] = length;
-    if (length < TGeoShape::Tolerance())
-        return 0.0;
-    Double_t invlen = 1. / length;
-    dir[0] = (end[0] - start[0]) * invlen;
-    dir[1] = (end[1] - start[1]) * invlen;
-    dir[2] = (end[2] - start[2]) * invlen;
-
-    // Initialize start point and direction
-    TGeoNode* currentnode = 0;
-    TGeoNode* startnode = gGeoManager->InitTrack(start, dir);
-    if (!startnode) {
-        LOG(ERROR) << "Start point out of geometry: x " << start[0] << ", y " << start[1] << ", z " << start[2];
-        return 0.0;
-    }
-    TGeoMaterial* material = startnode->GetVolume()->GetMedium()->GetMaterial();
-    lparam[0] = material->GetDensity();
-    if (lparam[0] > mparam[7])
-        mparam[7] = lparam[0];
-    lparam[1] = material->GetRadLen();
-    lparam[2] = material->GetA();
-    lparam[3] = material->GetZ();
-    lparam[4] = length;
-    lparam[5] = lparam[3] / lparam[2];
-    if (material->IsMixture()) {
-        TGeoMixture* mixture = (TGeoMixture*)material;
-        lparam[5] = 0;
-        Double_t sum = 0;
-        for (Int_t iel = 0; iel < mixture->GetNelements(); iel++) {
-            sum += mixture->GetWmixt()[iel];
-            lparam[5] += mixture->GetZmixt()[iel] * mixture->GetWmixt()[iel] / mixture->GetAmixt()[iel];
-        }
-        lparam[5] /= sum;
-    }
-
-    // Locate next boundary within length without computing safety.
-    // Propagate either with length (if no boundary found) or just cross boundary
-    gGeoManager->FindNextBoundaryAndStep(length, kFALSE);
-    Double_t step = 0.0;   // Step made
-    Double_t snext = gGeoManager->GetStep();
-    // If no boundary within proposed length, return current density
-    if (!gGeoManager->IsOnBoundary()) {
-        mparam[0] = lparam[0];
-        mparam[1] = lparam[4] / lparam[1];
-        mparam[2] = lparam[2];
-        mparam[3] = lparam[3];
-        mparam[4] = lparam[4];
-        return lparam[0];
-    }
-    // Try to cross the boundary and see what is next
-    Int_t nzero = 0;
-    while (length > TGeoShape::Tolerance()) {
-        currentnode = gGeoManager->GetCurrentNode();
-        if (snext < 2. * TGeoShape::Tolerance())
-            nzero++;
-        else
-            nzero = 0;
-        if (nzero > 3) {
-            // This means navigation has problems on one boundary
-            // Try to cross by making a small step
-            // AliErrorClass("Cannot cross boundary\n");
-            mparam[0] = bparam[0] / step;
-            mparam[1] = bparam[1];
-            mparam[2] = bparam[2] / step;
-            mparam[3] = bparam[3] / step;
-            mparam[5] = bparam[5] / step;
-            mparam[4] = step;
-            mparam[0] = 0.;        // if crash of navigation take mean density 0
-            mparam[1] = 1000000;   // and infinite rad length
-            return bparam[0] / step;
-        }
-        mparam[6] += 1.;
-        step += snext;
-        bparam[1] += snext / lparam[1];
-        bparam[2] += snext * lparam[2];
-        bparam[3] += snext * lparam[3];
-        bparam[5] += snext * lparam[5];
-        bparam[0] += snext * lparam[0];
-
-        if (snext >= length)
-            break;
-        if (!currentnode)
-            break;
-        length -= snext;
-        material = currentnode->GetVolume()->GetMedium()->GetMaterial();
-        lparam[0] = material->GetDensity();
-        if (lparam[0] > mparam[7])
-            mparam[7] = lparam[0];
-        lparam[1] = material->GetRadLen();
-        lparam[2] = material->GetA();
-        lparam[3] = material->GetZ();
-        lparam[5] = lparam[3] / lparam[2];
-        if (material->IsMixture()) {
-            TGeoMixture* mixture = (TGeoMixture*)material;
-            lparam[5] = 0;
-            Double_t sum = 0;
-            for (Int_t iel = 0; iel < mixture->GetNelements(); iel++) {
-                sum += mixture->GetWmixt()[iel];
-                lparam[5] += mixture->GetZmixt()[iel] * mixture->GetWmixt()[iel] / mixture->GetAmixt()[iel];
-            }
-            lparam[5] /= sum;
-        }
-        gGeoManager->FindNextBoundaryAndStep(length, kFALSE);
-        snext = gGeoManager->GetStep();
-    }
-    mparam[0] = bparam[0] / step;
-    mparam[1] = bparam[1];
-    mparam[2] = bparam[2] / step;
-    mparam[3] = bparam[3] / step;
-    mparam[5] = bparam[5] / step;
-    return bparam[0] / step;
-}
-
 // -----   Destructor   ----------------------------------------------------
 MuDISGenerator::~MuDISGenerator()
 {
@@ -271,39 +109,24 @@ Bool_t MuDISGenerator::ReadEvent(FairPrimaryGenerator* cpg)
     LOG(DEBUG) << "MuDIS: end position " << end[0] << ", " << end[1] << ", " << end[2];
 
     Double_t bparam;
-    Double_t mparam[8];
-    bparam = MeanMaterialBudget(start, end, mparam);
-    // loop over trajectory between start and end to pick an interaction point
-    Double_t prob2int = 0.;
-    Double_t xmu;
-    Double_t ymu;
-    Double_t zmu;
-    Int_t count = 0;
-    LOG(DEBUG) << "Info MuDISGenerator Start prob2int while loop, bparam= " << bparam << ", " << bparam * 1.e8;
+    Double_t mparam[10];
+    const MaterialProfile& profile = fMaterialSampler.Profile(start, end);
+    if (profile.GetSegments().empty()) {
+        LOG(ERROR) << "Start point out of geometry: x " << start[0] << ", y " << start[1] << ", z " << start[2];
+    }
+    bparam = profile.MeanMaterialBudget(mparam);
+    LOG(DEBUG) << "Info MuDISGenerator: bparam= " << bparam << ", " << bparam * 1.e8;
     LOG(DEBUG) << "Info MuDISGenerator What was maximum density, mparam[7]= " << mparam[7] << ", " << mparam[7] * 1.e8;
 
-    while (prob2int < gRandom->Uniform(0., 1.)) {
-        zmu = gRandom->Uniform(start[2], end[2]);
-        xmu = x - (z - zmu) * txmu;
-        ymu = y - (z - zmu) * tymu;
-        // get local material at this point
-        TGeoNode* node = gGeoManager->FindNode(xmu, ymu, zmu);
-        TGeoMaterial* mat = 0;
-        if (node && !gGeoManager->IsOutside())
-            mat = node->GetVolume()->GetMaterial();
-        LOG(DEBUG) << "Info MuDISGenerator: mat " << count << ", " << mat->GetName() << ", " << mat->GetDensity();
-        // density relative to Prob largest density along this trajectory, i.e. use rho(Pt)
-        prob2int = mat->GetDensity() / mparam[7];
-        if (prob2int > 1.) {
-            LOG(WARNING) << "MuDISGenerator: prob2int > Maximum density????";
-            LOG(WARNING) << "prob2int: " << prob2int;
-            LOG(WARNING) << "maxrho: " << mparam[7];
-            LOG(WARNING) << "material: " << mat->GetName();
-        }
-        count += 1;
+    // pick an interaction point along the trajectory, with probability proportional to the local density
+    Double_t u = profile.SampleDensity(gRandom->Uniform(0., 1.));
+    Double_t zmu = start[2] + u * (end[2] - start[2]);
+    Double_t xmu = x - (z - zmu) * txmu;
+    Double_t ymu = y - (z - zmu) * tymu;
+    if (const MaterialProfile::Segment* seg = profile.SegmentAt(u)) {
+        LOG(DEBUG) << "Info MuDISGenerator: density at interaction point " << seg->density;
     }
 
-    LOG(DEBUG) << "Info MuDISGenerator: prob2int " << prob2int << ", " << count;
     LOG(DEBUG) << "MuDIS: put position " << xmu << ", " << ymu << ", " << zmu;
 
     Double_t total_mom =
@@ -3,6 +3,7 @@
 
 #include "FairGenerator.h"
 #include "FairLogger.h"   // for FairLogger, MESSAGE_ORIGIN
+#include "MaterialBudgetSampler.h"
 #include "TClonesArray.h"
 #include "TF1.h"   // for TF1
 #include "TROOT.h"
@@ -33,8 +34,8 @@ class MuDISGenerator : public FairGenerator
         endZ = z_end;
     }
 
-  private:
-    Double_t MeanMaterialBudget(const Double_t* start, const Double_t* end, Double_t* mparam);
+    // share material profiles between muon trajectories within this x,y grid at startZ and endZ (cm), 0: exact
+    void SetProfileBinWidth(Double_t w) { fMaterialSampler.SetBinWidth(w); }
 
   protected:
     Double_t startZ, endZ;
@@ -47,6 +48,7 @@ class MuDISGenerator : public FairGenerator
     int fNevents;
     int fn;
     bool fFirst;
+    MaterialBudgetSampler fMaterialSampler;   //!
 
     ClassDef(MuDISGenerator, 1);
 };
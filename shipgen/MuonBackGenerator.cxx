@@ -7,6 +7,7 @@
 #include "TFile.h"
 #include "TMCProcess.h"
 #include "TMath.h"   // for Sqrt
+#include "TParameter.h"
 #include "TROOT.h"
 #include "TRandom.h"
 #include "TSystem.h"
@@ -15,6 +16,7 @@
 
 #include <algorithm>
 #include <math.h>
+#include <memory>
 #include <unordered_map>
 
 using ShipUnit::cm;
@@ -24,6 +26,9 @@ using ShipUnit::mm;
 // -----   Default constructor   -------------------------------------------
 MuonBackGenerator::MuonBackGenerator() {
  followMuons = true;
+ fUseIndex = kFALSE;
+ fIndexReady = kFALSE;
+ fCacheSize = 30000000;
 }
 // -------------------------------------------------------------------------
 // -----   Default constructor   -------------------------------------------
@@ -39,6 +44,7 @@ Bool_t MuonBackGenerator::Init(const char* fileName, const int firstEvent)
         LOG(fatal) << "Error opening the Signal file: " << fileName;
     }
   fn = firstEvent;
+  fIndexReady = kFALSE;
   fPaintBeam = 5 * cm;   // default value for painting beam
   fSameSeed = 0;
   fPhiRandomize = false;     // default value for phi randomization
@@ -99,6 +105,174 @@ Bool_t MuonBackGenerator::checkDiMuon(Int_t muIndex){
    return check;
 }
 
+// -----   Muon selection of a cbmsim entry   -------------------------------
+// fills muList with (MCTrack index, vetoPoint index) of the muons to transport,
+// or of all particles except neutrinos if not following only muons
+Bool_t MuonBackGenerator::SelectEntry(std::unordered_map<int, int>& muList, Bool_t applyDiMuon)
+{
+    std::unordered_map<int, std::vector<int>> moList;
+    muList.clear();
+    Bool_t found = false;
+    for (int i = 0; i < vetoPoints->GetEntries(); i++) {
+        auto* v = static_cast<vetoPoint*>(vetoPoints->At(i));
+        Int_t abspid = TMath::Abs(v->PdgCode());
+        if (abspid == 13 or (not followMuons and abspid != 12 and abspid != 14)) {
+            found = true;
+            Int_t muIndex = v->GetTrackID();
+            if (!applyDiMuon) {
+                muList.insert({muIndex, i});
+            } else if (abspid == 13) {
+                if (checkDiMuon(muIndex)) {
+                    moList[(dynamic_cast<ShipMCTrack*>(MCTrack->At(muIndex)))->GetMotherId()].push_back(i);
+                } else {
+                    muList.insert({muIndex, i});
+                }
+            }
+        }
+    }
+    // reject muon if comes from boosted channel
+    for (auto it = moList.begin(); it != moList.end(); it++) {
+        if (gRandom->Uniform(0., 1.) > 0.99) {
+            std::vector<int> list = it->second;
+            for (Int_t i = 0; i < list.size(); i++) {
+                auto* v = dynamic_cast<vetoPoint*>(vetoPoints->At(list.at(i)));
+                Int_t muIndex = v->GetTrackID();
+                muList.insert({muIndex, i});
+            }
+        }
+    }
+    return found;
+}
+// -----   Selection index   -----------------------------------------------
+Int_t MuonBackGenerator::SelectionCode() const
+{
+    return (id == -1 ? 1 : 0) + (followMuons ? 2 : 0);
+}
+
+void MuonBackGenerator::BuildSelectionIndex()
+{
+    fSelEntries.clear();
+    fSelOffsets.assign(1, 0);
+    fSelTracks.clear();
+    fSelPoints.clear();
+    Bool_t isCbmsim = id == -1;
+    // only the branch the selection looks at
+    fTree->SetBranchStatus("*", 0);
+    fTree->SetBranchStatus(isCbmsim ? "vetoPoint*" : "id", 1);
+    std::unordered_map<int, int> muList;
+    for (Long64_t n = 0; n < fNevents; n++) {
+        fTree->GetEntry(n);
+        if (isCbmsim) {
+            // the dimuon downscaling is random, it is applied when the entry is read
+            if (!SelectEntry(muList, kFALSE)) {
+                continue;
+            }
+            for (const auto& element : muList) {
+                fSelTracks.push_back(element.first);
+                fSelPoints.push_back(element.second);
+            }
+        } else if (TMath::Abs(int(id)) != 13) {
+            continue;
+        }
+        fSelEntries.push_back(n);
+        fSelOffsets.push_back(fSelTracks.size());
+    }
+    fTree->SetBranchStatus("*", 1);
+    LOGF(info, "MuonBackGenerator: selection index with %zu of %i entries", fSelEntries.size(), fNevents);
+}
+
+Bool_t MuonBackGenerator::ReadSelectionIndex()
+{
+    std::unique_ptr<TFile> f(TFile::Open(fIndexFile, "READ"));
+    if (!f || f->IsZombie()) {
+        return kFALSE;
+    }
+    auto* nEntries = f->Get<TParameter<Long64_t>>("nEntries");
+    auto* code = f->Get<TParameter<Int_t>>("selection");
+    auto* t = f->Get<TTree>("muonIndex");
+    if (!nEntries || !code || !t || nEntries->GetVal() != fNevents || code->GetVal() != SelectionCode()) {
+        LOGF(info, "MuonBackGenerator: selection index %s does not match the input, rebuilding", fIndexFile.Data());
+        return kFALSE;
+    }
+    Long64_t entry;
+    std::vector<Int_t>* tracks = nullptr;
+    std::vector<Int_t>* points = nullptr;
+    t->SetBranchAddress("entry", &entry);
+    t->SetBranchAddress("tracks", &tracks);
+    t->SetBranchAddress("points", &points);
+    fSelEntries.clear();
+    fSelOffsets.assign(1, 0);
+    fSelTracks.clear();
+    fSelPoints.clear();
+    for (Long64_t n = 0; n < t->GetEntries(); n++) {
+        t->GetEntry(n);
+        fSelEntries.push_back(entry);
+        fSelTracks.insert(fSelTracks.end(), tracks->begin(), tracks->end());
+        fSelPoints.insert(fSelPoints.end(), points->begin(), points->end());
+        fSelOffsets.push_back(fSelTracks.size());
+    }
+    t->ResetBranchAddresses();
+    delete tracks;
+    delete points;
+    LOGF(info, "MuonBackGenerator: selection index with %zu entries read from %s", fSelEntries.size(), fIndexFile.Data());
+    return kTRUE;
+}
+
+void MuonBackGenerator::WriteSelectionIndex()
+{
+    TDirectory* dir = gDirectory;
+    std::unique_ptr<TFile> f(TFile::Open(fIndexFile, "RECREATE"));
+    if (!f || f->IsZombie()) {
+        LOGF(warn, "MuonBackGenerator: cannot write selection index %s", fIndexFile.Data());
+        dir->cd();
+        return;
+    }
+    Long64_t entry;
+    std::vector<Int_t> tracks, points;
+    // owned by the file, deleted by Close
+    f->cd();
+    auto* t = new TTree("muonIndex", "entries passing the MuonBackGenerator selection");
+    t->Branch("entry", &entry);
+    t->Branch("tracks", &tracks);
+    t->Branch("points", &points);
+    for (size_t k = 0; k < fSelEntries.size(); k++) {
+        entry = fSelEntries[k];
+        tracks.assign(fSelTracks.begin() + fSelOffsets[k], fSelTracks.begin() + fSelOffsets[k + 1]);
+        points.assign(fSelPoints.begin() + fSelOffsets[k], fSelPoints.begin() + fSelOffsets[k + 1]);
+        t->Fill();
+    }
+    t->Write();
+    TParameter<Long64_t>("nEntries", fNevents).Write();
+    TParameter<Int_t>("selection", SelectionCode()).Write();
+    f->Close();
+    dir->cd();
+}
+
+void MuonBackGenerator::PrepareSelectionIndex()
+{
+    fIndexReady = kTRUE;
+    if (fIndexFile.Length() == 0 || !ReadSelectionIndex()) {
+        BuildSelectionIndex();
+        if (fIndexFile.Length() > 0) {
+            WriteSelectionIndex();
+        }
+    }
+    // read the selected entries through a TTreeCache, with only the branches needed
+    fTree->SetCacheSize(fCacheSize);
+    if (id == -1) {
+        fTree->AddBranchToCache("MCTrack*", kTRUE);
+        if (followMuons && !fdownScaleDiMuon) {
+            // the muon rows come from the index
+            fTree->SetBranchStatus("vetoPoint*", 0);
+        } else {
+            fTree->AddBranchToCache("vetoPoint*", kTRUE);
+        }
+    } else {
+        fTree->AddBranchToCache("*", kTRUE);
+    }
+    fTree->StopCacheLearningPhase();
+}
+
 // -----   Passing the event   ---------------------------------------------
 Bool_t MuonBackGenerator::ReadEvent(FairPrimaryGenerator* cpg)
 {
@@ -106,65 +280,55 @@ Bool_t MuonBackGenerator::ReadEvent(FairPrimaryGenerator* cpg)
     Double_t mass, e, tof, phi;
     Double_t dx = 0, dy = 0;
     std::unordered_map<int, int> muList;
-    std::unordered_map<int, std::vector<int>> moList;
-    while (fn < fNevents) {
-        fTree->GetEntry(fn);
-        muList.clear();
-        moList.clear();
-        fn++;
-        if (fn % 100000 == 0) {
-            LOGF(info, "Reading event %i", fn);
-        }
-        // test if we have a muon, don't look at neutrinos:
-        if (TMath::Abs(int(id)) == 13) {
-            mass = pdgBase->GetParticle(id)->Mass();
-            e = TMath::Sqrt(px * px + py * py + pz * pz + mass * mass);
-            tof = 0;
-            break;
+    if (fUseIndex) {
+        if (!fIndexReady) {
+            PrepareSelectionIndex();
         }
-        if (id == -1) {   // use tree as input file
-            Bool_t found = false;
-            for (int i = 0; i < vetoPoints->GetEntries(); i++) {
-                auto* v = dynamic_cast<vetoPoint*>(vetoPoints->At(i));
-                Int_t abspid = TMath::Abs(v->PdgCode());
-                if (abspid == 13 or (not followMuons and abspid != 12 and abspid != 14)) {
-                    found = true;
-                    Int_t muIndex = v->GetTrackID();
-                    if (!fdownScaleDiMuon) {
-                        muList.insert({muIndex, i});
-                    } else if (abspid == 13) {
-                        if (checkDiMuon(muIndex)) {
-                            moList[(dynamic_cast<ShipMCTrack*>(MCTrack->At(muIndex)))->GetMotherId()].push_back(i);
-                        } else {
-                            muList.insert({muIndex, i});
-                        }
+        // next selected entry at or after fn
+        size_t k = std::lower_bound(fSelEntries.begin(), fSelEntries.end(), Long64_t(fn)) - fSelEntries.begin();
+        if (k == fSelEntries.size()) {
+            fn = fNevents;
+        } else {
+            fTree->GetEntry(fSelEntries[k]);
+            fn = fSelEntries[k] + 1;
+            if (id == -1) {
+                if (fdownScaleDiMuon) {
+                    SelectEntry(muList, kTRUE);
+                } else {
+                    for (Int_t r = fSelOffsets[k]; r < fSelOffsets[k + 1]; r++) {
+                        muList.insert({fSelTracks[r], fSelPoints[r]});
                     }
                 }
             }
-            // reject muon if comes from boosted channel
-
-            for (auto it = moList.begin(); it != moList.end(); it++) {
-                if (gRandom->Uniform(0., 1.) > 0.99) {
-                    std::vector<int> list = it->second;
-                    for (Int_t i = 0; i < list.size(); i++) {
-                        auto* v = dynamic_cast<vetoPoint*>(vetoPoints->At(list.at(i)));
-                        Int_t muIndex = v->GetTrackID();
-                        muList.insert({muIndex, i});
-                    }
-                }
-            }
-            if (!found) {
-                LOGF(warn, "No muon found %i", fn - 1);
+        }
+    } else {
+        while (fn < fNevents) {
+            fTree->GetEntry(fn);
+            fn++;
+            if (fn % 100000 == 0) {
+                LOGF(info, "Reading event %i", fn);
             }
-            if (found) {
+            // test if we have a muon, don't look at neutrinos:
+            if (TMath::Abs(int(id)) == 13) {
                 break;
             }
+            if (id == -1) {   // use tree as input file
+                if (SelectEntry(muList, fdownScaleDiMuon)) {
+                    break;
+                }
+                LOGF(warn, "No muon found %i", fn - 1);
+            }
         }
-  }
+    }
   if (fn>fNevents-1){
      LOGF(info, "End of file reached %i", fNevents);
      return kFALSE;
   }
+  if (id != -1) {
+     mass = pdgBase->GetParticle(id)->Mass();
+     e = TMath::Sqrt(px * px + py * py + pz * pz + mass * mass);
+     tof = 0;
+  }
   if (fSameSeed) {
     Int_t theSeed = fn + fSameSeed * fNevents;
     LOGF(debug, "Seed: %d", theSeed);
@@ -198,11 +362,11 @@ Bool_t MuonBackGenerator::ReadEvent(FairPrimaryGenerator* cpg)
        tof =  track->GetStartT()/1E9; // convert back from ns to sec;
        e = track->GetEnergy();
        Bool_t wanttracking = false; // only transport muons
-       for (std::pair<int, int> element : muList){
-         if (element.first==i){
+       auto element = muList.find(i);
+       if (element != muList.end()){
           wanttracking = true;
           if (not followMuons){
-              auto* v = dynamic_cast<vetoPoint*>(vetoPoints->At(element.second));
+              auto* v = static_cast<vetoPoint*>(vetoPoints->At(element->second));
               TVector3 lpv = v->LastPoint();
               TVector3 lmv = v->LastMom();
               if (abspid == 22) {
@@ -216,8 +380,6 @@ Bool_t MuonBackGenerator::ReadEvent(FairPrimaryGenerator* cpg)
            vz = lpv[2];
            tof =  v->GetTime()/1E9; // convert back from ns to sec
           }
-          break;
-        }
        }
        cpg->AddTrack(track->GetPdgCode(),px,py,pz,vx,vy,vz,track->GetMotherId(),wanttracking,e,tof,track->GetWeight(),(TMCProcess)track->GetProcID());
      }
@@ -6,6 +6,10 @@
 #include "TTree.h"                      // for TTree
 #include "TClonesArray.h"
 #include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
+#include "TString.h"
+
+#include <unordered_map>
+#include <vector>
 
 class FairPrimaryGenerator;
 
@@ -35,8 +39,28 @@ class MuonBackGenerator : public FairGenerator
   void SetPhiRandomize(Bool_t phiRandomize) { fPhiRandomize = phiRandomize; };
   Bool_t checkDiMuon(Int_t muIndex);
   void SetDownScaleDiMuon(){ fdownScaleDiMuon = kTRUE; };
+  /** Read only the entries passing the muon selection, using an index built once per input file.
+      If sidecar is given, the index is read from this file if it matches the input, else written to it **/
+  void UseSelectionIndex(const char* sidecar = "") { fUseIndex = kTRUE; fIndexFile = sidecar; };
+  /** TTreeCache size in bytes used when reading through the selection index **/
+  void SetCacheSize(Long64_t bytes) { fCacheSize = bytes; };
 
 private:
+  Bool_t SelectEntry(std::unordered_map<int, int>& muList, Bool_t applyDiMuon);
+  void PrepareSelectionIndex();
+  void BuildSelectionIndex();
+  Bool_t ReadSelectionIndex();
+  void WriteSelectionIndex();
+  Int_t SelectionCode() const;
+
+  std::vector<Long64_t> fSelEntries;   //! selected entries
+  std::vector<Int_t> fSelOffsets;      //! first muon row of each selected entry, plus the total
+  std::vector<Int_t> fSelTracks;       //! muon rows: MCTrack index
+  std::vector<Int_t> fSelPoints;       //! muon rows: vetoPoint index
+  Bool_t fUseIndex;                    //!
+  Bool_t fIndexReady;                  //!
+  TString fIndexFile;                  //!
+  Long64_t fCacheSize;                 //!
 protected:
   Float_t id,parentid,pythiaid,w,px,py,pz,vx,vy,vz,ecut;
   TClonesArray* MCTrack; //!
@@ -12,7 +12,6 @@
 const Double_t cm = 10.; // pythia units are mm
 const Double_t c_light = 2.99792458e+10; // speed of light in cm/sec (c_light   = 2.99792458e+8 * m/s)
 Int_t counter = 0;
-const Double_t mbarn = 1E-3*1E-24*TMath::Na(); // cm^2 * Avogadro
 
 // -----   Default constructor   -------------------------------------------
 Pythia8Generator::Pythia8Generator()
@@ -95,7 +94,6 @@ Bool_t Pythia8Generator::Init()
   }
   fPythia->init();
   if (targetName!=""){
-   fMaterialInvestigator = new GenieGenerator();
    TGeoVolume* top = gGeoManager->GetTopVolume();
    TGeoNode* target = top->FindNode(targetName);
    if (!target){
@@ -112,7 +110,8 @@ Bool_t Pythia8Generator::Init()
    end[1]=yOff;
    end[2]=endZ;
 //find maximum interaction length
-   bparam = fMaterialInvestigator->MeanMaterialBudget(start, end, mparam);
+   fMaterialProfile.Fill(start, end);
+   bparam = fMaterialProfile.MeanMaterialBudget(mparam);
    maxCrossSection =  mparam[9];
   }
   return kTRUE;
@@ -158,42 +157,20 @@ Bool_t Pythia8Generator::ReadEvent(FairPrimaryGenerator* cpg)
   Double_t zinter=0;
   if (targetName!=""){
 // calculate primary proton interaction point:
-// loop over trajectory between start and end to pick an interaction point, copied from GenieGenerator and adapted to hadrons
-   Double_t prob2int = -1.;
-   Double_t rndm = 0.;
-   Double_t sigma;
-   Int_t count=0;
-   Double_t zinterStart = start[2];
+// draw it along the trajectory between start and end from the material profile of the target,
+// with probability sigma*exp(-interaction length from start)
+   Double_t uStart = 0.;
 // simulate more downstream interaction points for interactions down in the cascade
    Int_t nInter = ck[0]; if (nInter>16){nInter=16;}
    for( Int_t nI=0; nI<nInter; nI++){
-    // if (!subprocCodes[nI]<90){continue;}  //if process is not inelastic, go to next. Changed by taking now collision length
-    prob2int = -1.;
     Int_t intLengthFactor = 1; // for nucleons
     if (TMath::Abs(ancestors[nI]) < 1000){intLengthFactor = 1.16;} // for mesons
     // Fe: nuclear /\ 16.77 cm pion 20.42 cm  f=1.22
     // W:  nuclear /\ 9.946 cm pion 11.33 cm  f=1.14
     // Mo: nuclear /\ 15.25 cm pion 17.98 cm  f=1.18
-    while (prob2int<rndm) {
- //place x,y,z uniform along path
-      zinter = gRandom->Uniform(zinterStart,end[2]);
-      Double_t point[3]={xOff,yOff,zinter};
-      bparam = fMaterialInvestigator->MeanMaterialBudget(start, point, mparam);
-      Double_t interLength = mparam[8]  * intLengthFactor * 1.7; // 1.7 = interaction length / collision length from PDG Tables
-      TGeoNode *node = gGeoManager->FindNode(point[0],point[1],point[2]);
-      TGeoMaterial *mat = 0;
-      if (node && !gGeoManager->IsOutside()) {
-         mat = node->GetVolume()->GetMaterial();
-         Double_t n = mat->GetDensity()/mat->GetA();
-         sigma = 1./(n*mat->GetIntLen())/mbarn;   // no need to multiply with intLengthFactor, will cancel in next equation.
-         prob2int = TMath::Exp(-interLength)*sigma/maxCrossSection;
-      }else{
-         prob2int=0.;
-      }
-      rndm = gRandom->Uniform(0.,1.);
-      count+=1;
-    }
-    zinterStart = zinter;
+    // 1.7 = interaction length / collision length from PDG Tables
+    uStart = fMaterialProfile.SampleInteraction(uStart, intLengthFactor * 1.7, gRandom->Uniform(0.,1.));
+    zinter = start[2] + uStart*(end[2]-start[2]);
    }
    zinter = zinter*cm;
   }
@@ -6,7 +6,7 @@
 #include "Pythia8/Pythia.h"
 #include "FairLogger.h"                 // for FairLogger, MESSAGE_ORIGIN
 #include "TTree.h"
-#include "GenieGenerator.h"
+#include "MaterialBudgetSampler.h"
 
 class FairPrimaryGenerator;
 
@@ -56,7 +56,7 @@ class Pythia8Generator : public FairGenerator
   Pythia8::Pythia* fPythia;             //!
   Double_t fFDs;       // correction for Pythia6 to match measured Ds production
   Int_t fnRetries;     //
-  GenieGenerator* fMaterialInvestigator;  //!
+  MaterialProfile fMaterialProfile;  //!
   ClassDef(Pythia8Generator,3);
   TString targetName;
   Double_t xOff;
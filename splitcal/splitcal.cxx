@@ -20,6 +20,9 @@
 #include "TVirtualMC.h"
 #include "TGeoManager.h"
 #include "TGeoBBox.h"
+#include "TGeoMatrix.h"
+#include "TGeoNavigator.h"
+#include "TGeoNode.h"
 #include "TGeoCompositeShape.h"
 #include "TGeoShapeAssembly.h"
 #include "TGeoTube.h"
@@ -32,10 +35,14 @@
 #include "TView3D.h"
 
 
+#include <cstring>
 #include <iostream>
 using std::cout;
 using std::endl;
 
+std::unordered_map<Int_t, splitcal::StripLayout> splitcal::fStripLayout;
+TGeoManager* splitcal::fStripLayoutGeo = nullptr;
+
 splitcal::splitcal()
   : FairDetector("splitcal", kTRUE, kSplitCal),
     fTrackID(-1),
@@ -464,3 +471,64 @@ splitcalPoint* splitcal::AddHit(Int_t trackID, Int_t detID,
   return new(clref[size]) splitcalPoint(trackID, detID, pos, mom,
          time, length, eLoss, pdgCode);
 }
+
+// -----   Static method DecodeDetectorID    -------------------------------------------
+// -----   same fields as the zero padded 9 digit string decoding of splitcalHit -----------------------------------
+void splitcal::DecodeDetectorID(Int_t detID, Int_t& isPrecision, Int_t& nLayer, Int_t& nModuleX, Int_t& nModuleY, Int_t& nStrip)
+{
+  isPrecision = detID / 100000000;
+  nLayer = (detID / 100000) % 1000;
+  nModuleX = (detID / 10000) % 10;
+  nModuleY = (detID / 1000) % 10;
+  nStrip = detID % 1000;
+}
+
+// -----   Static method BuildStripLayoutTable    -------------------------------------------
+// -----   walks the strips and gas layers of SplitCalDetector once and stores their global centres -----------------------------------
+void splitcal::BuildStripLayoutTable()
+{
+  fStripLayout.clear();
+  fStripLayoutGeo = gGeoManager;
+  if (!gGeoManager) {return;}
+  TGeoNavigator* navigator = gGeoManager->GetCurrentNavigator();
+  if (!navigator->cd("cave/SplitCalDetector_1")) {
+    cout << "splitcal::BuildStripLayoutTable: no SplitCalDetector in the geometry" << endl;
+    return;
+  }
+  TGeoVolume* caloVolume = navigator->GetCurrentVolume();
+  for (Int_t i = 0; i < caloVolume->GetNdaughters(); i++) {
+    TGeoNode* node = caloVolume->GetNode(i);
+    const char* name = node->GetVolume()->GetName();
+    Bool_t isGas = strcmp(name, "ECALdet_gas") == 0;
+    if (!isGas && strcmp(name, "stripGivingX") != 0 && strcmp(name, "stripGivingY") != 0) {continue;}
+    StripLayout strip;
+    Int_t detID = node->GetNumber();
+    DecodeDetectorID(detID, strip.isPrecision, strip.layer, strip.moduleX, strip.moduleY, strip.strip);
+    // same assignment as splitcalHit::GetDetectorElementName
+    strip.isX = strip.isPrecision == 1 || strip.layer % 2 != 0;
+    strip.isY = strip.isPrecision == 1 || strip.layer % 2 == 0;
+    Double_t master[3] = {0., 0., 0.};
+    navigator->LocalToMaster(node->GetMatrix()->GetTranslation(), master);
+    strip.x = master[0];
+    strip.y = master[1];
+    strip.z = master[2];
+    TGeoBBox* box = static_cast<TGeoBBox*>(node->GetVolume()->GetShape());
+    strip.dx = box->GetDX();
+    strip.dy = box->GetDY();
+    strip.dz = box->GetDZ();
+    // with two gas layers per precision layer both have the same number, GetNode by name finds the first
+    fStripLayout.emplace(detID, strip);
+  }
+  cout << "splitcal: strip layout table filled for " << fStripLayout.size() << " elements" << endl;
+}
+
+// -----   Static method GetStripLayout    -------------------------------------------
+const splitcal::StripLayout* splitcal::GetStripLayout(Int_t detID)
+{
+  if (fStripLayoutGeo != gGeoManager) {
+    BuildStripLayoutTable();
+  }
+  auto it = fStripLayout.find(detID);
+  if (it == fStripLayout.end()) {return nullptr;}
+  return &it->second;
+}
@@ -6,9 +6,12 @@
 #include "TVector3.h"
 #include "TLorentzVector.h"
 
+#include <unordered_map>
+
 class splitcalPoint;
 class FairVolume;
 class TClonesArray;
+class TGeoManager;
 
 class splitcal: public FairDetector
 {
@@ -64,6 +67,23 @@ class splitcal: public FairDetector
 
     void SetYMax(Double_t yMax);
 
+    /** Layout of one sensitive element (strip or high precision gas layer) */
+    struct StripLayout {
+      Double_t x, y, z;          // centre in the global frame
+      Double_t dx, dy, dz;       // box half lengths
+      Int_t isPrecision, layer, moduleX, moduleY, strip;
+      Bool_t isX, isY;           // the element measures x and/or y
+    };
+
+    /**      Layout of the element with this detector ID, or nullptr if it is not in the geometry.
+     *       The table is filled from the (closed) geometry on first use
+    */
+    static const StripLayout* GetStripLayout(Int_t detID);
+    /**      Fill the layout table walking the SplitCalDetector nodes once */
+    static void BuildStripLayoutTable();
+    /**      Decode a detector ID: isPrecision (1 digit), layer (3), module x (1), module y (1), strip (3) */
+    static void DecodeDetectorID(Int_t detID, Int_t& isPrecision, Int_t& nLayer, Int_t& nModuleX, Int_t& nModuleY, Int_t& nStrip);
+
 
     /**      Create the detector geometry        */
     void ConstructGeometry();
@@ -128,6 +148,9 @@ class splitcal: public FairDetector
     splitcal& operator=(const splitcal&);
     Int_t InitMedium(const char* name);
 
+    static std::unordered_map<Int_t, StripLayout> fStripLayout;   //!  layout per detector ID
+    static TGeoManager* fStripLayoutGeo;                          //!  geometry used to fill the table
+
     ClassDef(splitcal,1)
 };
 
@@ -56,7 +56,9 @@ void splitcalCluster::ComputeEtaPhiE()
   // loop over hits to compute cluster energy sum and to compute the coordinates weighted average per layer
   double energy = 0.;
   for (auto hit : _vectorOfHits){
-    energy += hit->GetEnergyForCluster(_index);
+    // weighted energy of the hit, the weight lookup is a linear search
+    double hitEnergy = hit->GetEnergyForCluster(_index);
+    energy += hitEnergy;
     int layer = hit->GetLayerNumber();
     // hits from high precision layers give both x and y coordinates --> use if-if instead of if-else
     if (hit->IsX()){
@@ -64,8 +66,8 @@ void splitcalCluster::ComputeEtaPhiE()
 	mapLayerWeigthedX[layer] = 0.;
 	mapLayerSumWeigthsX[layer] = 0.;
       }
-      mapLayerWeigthedX[layer] += hit->GetX()*hit->GetEnergyForCluster(_index);
-      mapLayerSumWeigthsX[layer] += hit->GetEnergyForCluster(_index);
+      mapLayerWeigthedX[layer] += hit->GetX()*hitEnergy;
+      mapLayerSumWeigthsX[layer] += hitEnergy;
       mapLayerZ1[layer] = hit->GetZ();
     }
     if (hit->IsY()){
@@ -73,8 +75,8 @@ void splitcalCluster::ComputeEtaPhiE()
 	mapLayerWeigthedY[layer] = 0.;
 	mapLayerSumWeigthsY[layer] = 0.;
       }
-      mapLayerWeigthedY[layer] += hit->GetY()*hit->GetEnergyForCluster(_index);
-      mapLayerSumWeigthsY[layer] += hit->GetEnergyForCluster(_index);
+      mapLayerWeigthedY[layer] += hit->GetY()*hitEnergy;
+      mapLayerSumWeigthsY[layer] += hitEnergy;
       mapLayerZ2[layer] = hit->GetZ();
     }
   }//end loop on hit
@@ -0,0 +1,271 @@
+#include "splitcalClusterFinder.h"
+
+#include "splitcalCluster.h"
+#include "splitcalHit.h"
+#include "TClonesArray.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace {
+// allow one 'missing' hit in x/y: the x (y) error of hits measuring x (y) is scaled by this
+const Double_t kMaxGap = 2.;
+// the z distance may be up to this many times the sum of the z errors, in step 1 and step 2
+Double_t ZFactor(Int_t step) { return step == 1 ? 2. : 6.; }
+}
+
+// -----   Default constructor   -------------------------------------------
+splitcalClusterFinder::splitcalClusterFinder()
+  : fNoiseThreshold(0.002),
+    fMinSubclusterSize(5),
+    fInput(nullptr),
+    fCellMin{0., 0., 0.},
+    fCellSize{1., 1., 1.},
+    fNCells{1, 1, 1}
+{
+}
+// -------------------------------------------------------------------------
+
+Bool_t splitcalClusterFinder::IsNeighbour(Int_t hit1, Int_t hit2, Int_t step) const
+{
+  // same conditions as shipDigiReco.getNeighbours, not symmetric in hit1 and hit2
+  Double_t Dx = fabs(fX[hit2] - fX[hit1]);
+  Double_t Dy = fabs(fY[hit2] - fY[hit1]);
+  Double_t Dz = fabs(fZ[hit2] - fZ[hit1]);
+  Double_t errX = fErrX[hit1] + fErrX[hit2];
+  Double_t errY = fErrY[hit1] + fErrY[hit2];
+  Double_t errZ = ZFactor(step) * (fErrZ[hit1] + fErrZ[hit2]);
+  // use Dz instead of Dlayer due to split of 1m between the 2 parts of the calo
+  if (fIsX[hit1] && Dx <= errX && Dz <= errZ && ((Dy <= errY && Dz > 0.) || Dy == 0)) return kTRUE;
+  if (fIsY[hit1] && Dy <= errY && Dz <= errZ && ((Dx <= errX && Dz > 0.) || Dx == 0)) return kTRUE;
+  return kFALSE;
+}
+
+void splitcalClusterFinder::FillGrid(const Cluster& input, Int_t step)
+{
+  // the cell size is the largest distance at which two of the input hits can be
+  // neighbours, so all neighbours of a hit are in the adjacent cells
+  fInput = &input;
+  fGrid.clear();
+  const std::vector<Double_t>* coord[3] = {&fX, &fY, &fZ};
+  Double_t maxErr[3] = {0., 0., 0.};
+  for (Int_t a = 0; a < 3; a++) {
+    fCellMin[a] = 0.;
+  }
+  for (size_t pos = 0; pos < input.size(); pos++) {
+    Int_t hit = input[pos];
+    maxErr[0] = std::max(maxErr[0], fErrX[hit]);
+    maxErr[1] = std::max(maxErr[1], fErrY[hit]);
+    maxErr[2] = std::max(maxErr[2], fErrZ[hit]);
+    for (Int_t a = 0; a < 3; a++) {
+      Double_t c = (*coord[a])[hit];
+      if (pos == 0 || c < fCellMin[a]) fCellMin[a] = c;
+    }
+  }
+  maxErr[2] *= ZFactor(step);
+  for (Int_t a = 0; a < 3; a++) {
+    fCellSize[a] = 2. * maxErr[a] * (1. + 1e-9);
+    if (!(fCellSize[a] > 0.)) fCellSize[a] = 1.;
+    fNCells[a] = 1;
+    fHitCell[a].resize(fHits.size());
+  }
+  for (size_t pos = 0; pos < input.size(); pos++) {
+    Int_t hit = input[pos];
+    for (Int_t a = 0; a < 3; a++) {
+      fHitCell[a][hit] = Int_t(((*coord[a])[hit] - fCellMin[a]) / fCellSize[a]);
+      fNCells[a] = std::max(fNCells[a], Long64_t(fHitCell[a][hit]) + 1);
+    }
+  }
+  for (size_t pos = 0; pos < input.size(); pos++) {
+    Int_t hit = input[pos];
+    Long64_t key = (fHitCell[0][hit] * fNCells[1] + fHitCell[1][hit]) * fNCells[2] + fHitCell[2][hit];
+    fGrid[key].push_back(pos);
+  }
+}
+
+void splitcalClusterFinder::GetNeighbours(Int_t hit, Int_t step, Cluster& neighbours)
+{
+  neighbours.clear();
+  // positions in the input of all hits in the adjacent cells, to keep the input order
+  std::vector<Int_t> candidates;
+  for (Long64_t cx = fHitCell[0][hit] - 1; cx <= fHitCell[0][hit] + 1; cx++) {
+    if (cx < 0 || cx >= fNCells[0]) continue;
+    for (Long64_t cy = fHitCell[1][hit] - 1; cy <= fHitCell[1][hit] + 1; cy++) {
+      if (cy < 0 || cy >= fNCells[1]) continue;
+      for (Long64_t cz = fHitCell[2][hit] - 1; cz <= fHitCell[2][hit] + 1; cz++) {
+        if (cz < 0 || cz >= fNCells[2]) continue;
+        auto it = fGrid.find((cx * fNCells[1] + cy) * fNCells[2] + cz);
+        if (it == fGrid.end()) continue;
+        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+      }
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  for (Int_t pos : candidates) {
+    Int_t hit2 = (*fInput)[pos];
+    if (hit2 != hit && IsNeighbour(hit, hit2, step)) neighbours.push_back(hit2);
+  }
+}
+
+std::vector<splitcalClusterFinder::Cluster> splitcalClusterFinder::Clustering(const Cluster& input, Int_t step)
+{
+  std::vector<Cluster> clusters;
+  FillGrid(input, step);
+  Cluster neighbours;
+  Cluster expandNeighbours;
+  for (Int_t hit : input) {
+    if (fHits[hit]->IsUsed() == 1) continue;
+    GetNeighbours(hit, step, neighbours);
+    // lonely fragment
+    if (neighbours.empty()) continue;
+    fHits[hit]->SetIsUsed(1);
+    Cluster cluster(1, hit);
+    for (Int_t n : neighbours) fInList[n] = kTRUE;
+    // the neighbour list grows while it is processed
+    for (size_t k = 0; k < neighbours.size(); k++) {
+      Int_t neighbouringHit = neighbours[k];
+      if (fHits[neighbouringHit]->IsUsed() == 1) continue;
+      fHits[neighbouringHit]->SetIsUsed(1);
+      cluster.push_back(neighbouringHit);
+      GetNeighbours(neighbouringHit, step, expandNeighbours);
+      for (Int_t additionalHit : expandNeighbours) {
+        if (fInList[additionalHit]) continue;
+        fInList[additionalHit] = kTRUE;
+        neighbours.push_back(additionalHit);
+      }
+    }
+    for (Int_t n : neighbours) fInList[n] = kFALSE;
+    clusters.push_back(cluster);
+  }
+  return clusters;
+}
+
+std::vector<splitcalClusterFinder::Cluster> splitcalClusterFinder::ExcludeFragments(std::vector<Cluster>& subclusters) const
+{
+  std::vector<Int_t> fragmentIndices;
+  std::vector<Int_t> subclusterIndices;
+  for (size_t k = 0; k < subclusters.size(); k++) {
+    if (Int_t(subclusters[k].size()) < fMinSubclusterSize) fragmentIndices.push_back(k);
+    else subclusterIndices.push_back(k);
+  }
+  // merge fragments in the closest subcluster. If there is no subcluster but everything is fragmented, merge all the fragments together.
+  // As in python, the closest distance is not reset between fragments
+  Double_t minDistance = -1;
+  Int_t minIndex = -1;
+  if (subclusterIndices.empty() && !fragmentIndices.empty()) subclusterIndices.push_back(0);
+  for (Int_t indexFragment : fragmentIndices) {
+    Int_t firstHitFragment = subclusters[indexFragment][0];
+    for (Int_t indexSubcluster : subclusterIndices) {
+      Int_t firstHitSubcluster = subclusters[indexSubcluster][0];
+      Double_t distance;
+      if (fIsX[firstHitFragment]) distance = fabs(fX[firstHitFragment] - fX[firstHitSubcluster]);
+      else distance = fabs(fY[firstHitFragment] - fY[firstHitSubcluster]);
+      if (minDistance < 0 || distance < minDistance) {
+        minDistance = distance;
+        minIndex = indexSubcluster;
+      }
+    }
+    // in case there were only fragments - this is to prevent to sum twice fragment 0
+    if (minIndex != indexFragment) {
+      subclusters[minIndex].insert(subclusters[minIndex].end(), subclusters[indexFragment].begin(), subclusters[indexFragment].end());
+    }
+  }
+  std::vector<Cluster> result;
+  for (Int_t indexSubcluster : subclusterIndices) result.push_back(subclusters[indexSubcluster]);
+  return result;
+}
+
+Double_t splitcalClusterFinder::GetClusterEnergy(const Cluster& hits) const
+{
+  Double_t energy = 0;
+  for (Int_t hit : hits) energy += fHits[hit]->GetEnergy();
+  return energy;
+}
+
+// -----   Public method Exec   --------------------------------------------
+Int_t splitcalClusterFinder::Exec(TClonesArray* hits, TClonesArray* clusters)
+{
+  clusters->Delete();
+
+  // hit selection: hits above noise threshold are used in cluster reconstruction
+  fHits.clear();
+  fX.clear(); fY.clear(); fZ.clear();
+  fErrX.clear(); fErrY.clear(); fErrZ.clear();
+  fIsX.clear(); fIsY.clear();
+  for (Int_t i = 0; i < hits->GetEntriesFast(); i++) {
+    splitcalHit* hit = static_cast<splitcalHit*>(hits->At(i));
+    if (!hit || !(hit->GetEnergy() > fNoiseThreshold)) continue;
+    hit->SetIsUsed(0);
+    fHits.push_back(hit);
+    fX.push_back(hit->GetX());
+    fY.push_back(hit->GetY());
+    fZ.push_back(hit->GetZ());
+    fErrX.push_back(hit->IsX() ? hit->GetXError() * kMaxGap : hit->GetXError());
+    fErrY.push_back(hit->IsY() ? hit->GetYError() * kMaxGap : hit->GetYError());
+    fErrZ.push_back(hit->GetZError());
+    fIsX.push_back(hit->IsX());
+    fIsY.push_back(hit->IsY());
+  }
+  Int_t nHits = fHits.size();
+  fInList.assign(nHits, kFALSE);
+
+  // step 1: group of neighbouring cells: loose criteria -> splitting clusters is easier than merging clusters
+  Cluster all(nHits);
+  for (Int_t i = 0; i < nHits; i++) all[i] = i;
+  std::vector<Cluster> clustersOfHits = Clustering(all, 1);
+
+  // step 2: to check if clusters can be split do clustering separately in the XZ and YZ planes
+  std::vector<Cluster> finalClusters;
+  for (const Cluster& clusterOfHits : clustersOfHits) {
+    Cluster hitsX, hitsY;
+    for (Int_t hit : clusterOfHits) {
+      fHits[hit]->SetIsUsed(0);
+      if (fIsX[hit]) hitsX.push_back(hit);
+      if (fIsY[hit]) hitsY.push_back(hit);
+    }
+
+    // hits of the high precision layers are in both lists, they can only be used by the x reclustering
+    std::vector<Cluster> subclustersOfX = Clustering(hitsX, 2);
+    Double_t clusterEnergyX = GetClusterEnergy(hitsX);
+    std::vector<Cluster> subclustersX = ExcludeFragments(subclustersOfX);
+    std::vector<Double_t> weightsFromX;
+    for (const Cluster& subcluster : subclustersX) weightsFromX.push_back(GetClusterEnergy(subcluster) / clusterEnergyX);
+
+    std::vector<Cluster> subclustersOfY = Clustering(hitsY, 2);
+    Double_t clusterEnergyY = GetClusterEnergy(hitsY);
+    std::vector<Cluster> subclustersY = ExcludeFragments(subclustersOfY);
+    std::vector<Double_t> weightsFromY;
+    for (const Cluster& subcluster : subclustersY) weightsFromY.push_back(GetClusterEnergy(subcluster) / clusterEnergyY);
+
+    // final list of clusters: one per pair of x and y subclusters, hits weighted by the energy fraction of the other view.
+    // The python version meant to keep unsplit clusters as they are, but its check never passed, so they are always rebuilt here too
+    for (size_t ix = 0; ix < subclustersX.size(); ix++) {
+      for (size_t iy = 0; iy < subclustersY.size(); iy++) {
+        Int_t indexFinalCluster = finalClusters.size();
+        Cluster finalCluster;
+        for (Int_t hit : subclustersY[iy]) {
+          fHits[hit]->AddClusterIndex(indexFinalCluster);
+          fHits[hit]->AddEnergyWeight(weightsFromX[ix]);
+          finalCluster.push_back(hit);
+        }
+        for (Int_t hit : subclustersX[ix]) {
+          fHits[hit]->AddClusterIndex(indexFinalCluster);
+          fHits[hit]->AddEnergyWeight(weightsFromY[iy]);
+          finalCluster.push_back(hit);
+        }
+        finalClusters.push_back(finalCluster);
+      }
+    }
+  }
+
+  // fill clusters
+  for (size_t i = 0; i < finalClusters.size(); i++) {
+    const Cluster& finalCluster = finalClusters[i];
+    splitcalCluster* aCluster = new ((*clusters)[i]) splitcalCluster(fHits[finalCluster[0]]);
+    for (size_t j = 1; j < finalCluster.size(); j++) aCluster->AddHit(fHits[finalCluster[j]]);
+    aCluster->SetIndex(i);
+    aCluster->ComputeEtaPhiE();
+  }
+  return finalClusters.size();
+}
+// -------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+#ifndef SPLITCALCLUSTERFINDER_H
+#define SPLITCALCLUSTERFINDER_H 1
+
+#include "Rtypes.h"
+
+#include <unordered_map>
+#include <vector>
+
+class splitcalHit;
+class TClonesArray;
+
+/**
+ ** Cluster reconstruction of the SplitCal digitised hits, same algorithm as the
+ ** original python implementation in shipDigiReco (now clusterSplitcalPython):
+ **  - step 1: group neighbouring hits above the noise threshold
+ **  - step 2: recluster every group separately with the x and the y hits, merge
+ **    small subclusters (fragments) into the closest one and make one cluster per
+ **    pair of x and y subclusters, with the hits shared between them weighted by
+ **    the subcluster energy fractions.
+ ** Neighbours are searched in the cells adjacent to the hit in a grid with the
+ ** cell size of the largest neighbour distance, instead of in all hits. Clusters
+ ** are grown in the same order as in python, so that the output is identical.
+ **/
+class splitcalClusterFinder
+{
+  public:
+
+    splitcalClusterFinder();
+    virtual ~splitcalClusterFinder() = default;
+
+    /** hits with energy above threshold [GeV] are clustered, default 0.002 GeV **/
+    void SetNoiseThreshold(Double_t e) { fNoiseThreshold = e; }
+    /** subclusters with fewer hits are merged into the closest larger one, default 5 **/
+    void SetMinSubclusterSize(Int_t n) { fMinSubclusterSize = n; }
+
+    /** Cluster the hits and fill the clusters array, returns the number of clusters **/
+    Int_t Exec(TClonesArray* hits, TClonesArray* clusters);
+
+    /** Hits above the noise threshold of the last event **/
+    const std::vector<splitcalHit*>& GetHitsAboveThreshold() const { return fHits; }
+
+  private:
+
+    typedef std::vector<Int_t> Cluster;
+
+    /** Clustering of the given hits (indices into fHits), step 1 or 2 **/
+    std::vector<Cluster> Clustering(const Cluster& input, Int_t step);
+    /** Same as python getNeighbours, in input order, without duplicates **/
+    void GetNeighbours(Int_t hit, Int_t step, Cluster& neighbours);
+    Bool_t IsNeighbour(Int_t hit1, Int_t hit2, Int_t step) const;
+    void FillGrid(const Cluster& input, Int_t step);
+    /** Merge the fragments into the closest subcluster, same as python GetSubclustersExcludingFragments **/
+    std::vector<Cluster> ExcludeFragments(std::vector<Cluster>& subclusters) const;
+    Double_t GetClusterEnergy(const Cluster& hits) const;
+
+    Double_t fNoiseThreshold;
+    Int_t fMinSubclusterSize;
+
+    /** hits above threshold and their cached coordinates, errors already scaled by the allowed gap **/
+    std::vector<splitcalHit*> fHits;
+    std::vector<Double_t> fX, fY, fZ;
+    std::vector<Double_t> fErrX, fErrY, fErrZ;
+    std::vector<Bool_t> fIsX, fIsY;
+
+    /** grid of the current clustering input: cell -> positions in the input, ascending **/
+    std::unordered_map<Long64_t, Cluster> fGrid;
+    const Cluster* fInput;
+    std::vector<Int_t> fHitCell[3];
+    Double_t fCellMin[3];
+    Double_t fCellSize[3];
+    Long64_t fNCells[3];
+    std::vector<Bool_t> fInList;         ///< hit is already in the neighbour list of the current cluster
+};
+
+#endif   // SPLITCALCLUSTERFINDER_H
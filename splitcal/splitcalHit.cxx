@@ -51,53 +51,41 @@ splitcalHit::splitcalHit(splitcalPoint* p, Double_t t0)
   // SetDigi(SetTimeRes(fdigi));
   SetDetectorID(detID);
 
-  TGeoNavigator* navigator = gGeoManager->GetCurrentNavigator();
-  navigator->cd("cave/SplitCalDetector_1");
-  TGeoVolume* caloVolume = navigator->GetCurrentVolume();
-  // caloVolume->PrintNodes();
-
-  std::string stripName = GetDetectorElementName(detID); // it also sets if strip gives x or y coordinate
-
   int isPrec, nL, nMx, nMy, nS;
-  Decoder(detID, isPrec, nL, nMx, nMy, nS);
-
+  splitcal::DecodeDetectorID(detID, isPrec, nL, nMx, nMy, nS);
   SetIDs(isPrec, nL, nMx, nMy, nS);
 
-  TGeoNode* strip = caloVolume->GetNode(stripName.c_str());
-
-  const Double_t* stripCoordinatesLocal = strip->GetMatrix()->GetTranslation();
-  Double_t stripCoordinatesMaster[3] = {0.,0.,0.};
-  navigator->LocalToMaster(stripCoordinatesLocal, stripCoordinatesMaster);
-
-  TGeoBBox* box = (TGeoBBox*)strip->GetVolume()->GetShape();
-  double xHalfLength = box->GetDX();
-  double yHalfLength = box->GetDY();
-  double zHalfLength = box->GetDZ();
-
-  TGeoNode* passiveLayer = caloVolume->GetNode("ECALfilter_200000"); // they are all the same
-  TGeoBBox* boxPassive = (TGeoBBox*)passiveLayer->GetVolume()->GetShape();
-  double zPassiveHalfLength = box->GetDZ();
+  // strip centre and size from the layout table, filled once per geometry
+  const splitcal::StripLayout* strip = splitcal::GetStripLayout(detID);
+  if (!strip) {
+    cout << "splitcalHit: detector ID " << detID << " not found in the SplitCal geometry" << endl;
+    SetEnergy(pointE);
+    return;
+  }
+  SetIsX(strip->isX);
+  SetIsY(strip->isY);
+  double stripCoordinatesMaster[3] = {strip->x, strip->y, strip->z};
+  double xHalfLength = strip->dx;
+  double yHalfLength = strip->dy;
+  double zHalfLength = strip->dz;
+  // the passive layer half length used to be read from the strip box as well
+  double zPassiveHalfLength = strip->dz;
 
   // std::cout<< "----------------------"<<std::endl;
   // std::cout<< "-- pointX = " << pointX << std::endl;
   // std::cout<< "-- pointY = " << pointY << std::endl;
   // std::cout<< "-- pointZ = " << pointZ << std::endl;
   // std::cout<< "-- detID = " << detID << std::endl;
-  // std::cout<< "-- stripName = " << stripName << std::endl;
   // std::cout<< "-- isPrec = " << isPrec << std::endl;
   // std::cout<< "-- nL = " << nL << std::endl;
   // std::cout<< "-- nMx = " << nMx << std::endl;
   // std::cout<< "-- nMy = " << nMy << std::endl;
   // std::cout<< "-- nS = " << nS << std::endl;
-  // std::cout<< "-- stripCoordinatesLocal[0] = " << stripCoordinatesLocal[0] << std::endl;
-  // std::cout<< "-- stripCoordinatesLocal[1] = " << stripCoordinatesLocal[1] << std::endl;
-  // std::cout<< "-- stripCoordinatesLocal[2] = " << stripCoordinatesLocal[2] << std::endl;
   // std::cout<< "-- stripCoordinatesMaster[0] = " << stripCoordinatesMaster[0] << std::endl;
   // std::cout<< "-- stripCoordinatesMaster[1] = " << stripCoordinatesMaster[1] << std::endl;
   // std::cout<< "-- stripCoordinatesMaster[2] = " << stripCoordinatesMaster[2] << std::endl;
 
 
-  // TGeoNode* check = navigator->FindNode(pointX,pointY,pointZ);
 
   SetEnergy(pointE);
   if (isPrec==1) SetXYZ(pointX,pointY,stripCoordinatesMaster[2]);
@@ -170,8 +158,7 @@ void splitcalHit::Decoder(std::string& encodedID, int& isPrecision, int& nLayer,
 
 void splitcalHit::Decoder(int& id, int& isPrecision, int& nLayer, int& nModuleX,  int& nModuleY, int& nStrip){
 
-  std::string encodedID = GetPaddedString(id);
-  Decoder(encodedID, isPrecision, nLayer, nModuleX, nModuleY, nStrip);
+  splitcal::DecodeDetectorID(id, isPrecision, nLayer, nModuleX, nModuleY, nStrip);
 
 }
 
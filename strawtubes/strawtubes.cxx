@@ -23,6 +23,8 @@
 #include "TGeoManager.h"
 #include "TGeoMaterial.h"
 #include "TGeoMedium.h"
+#include "TGeoNavigator.h"
+#include "TGeoNode.h"
 #include "TGeoTube.h"
 #include "TMath.h"
 #include "TParticle.h"
@@ -30,12 +32,27 @@
 #include "TVirtualMC.h"
 #include "strawtubesPoint.h"
 
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <tuple>
 using std::cout;
 using std::endl;
 
+namespace {
+// dimensions of the straw end point table: station, view, layer, straw
+const Int_t kTableStations = 4;
+const Int_t kTableViews = 4;
+const Int_t kTableLayers = 2;
+const Int_t kTableStraws = 300;
+const Int_t kTableSize = kTableStations * kTableViews * kTableLayers * kTableStraws;
+}
+
+std::vector<Double_t> strawtubes::fStrawEndPoints;
+std::vector<Bool_t> strawtubes::fStrawEndPointsSet;
+TGeoManager* strawtubes::fStrawEndPointsGeo = nullptr;
+
 strawtubes::strawtubes()
     : FairDetector("Strawtubes", kTRUE, kStraw)
     , fTrackID(-1)
@@ -523,9 +540,127 @@ std::tuple<Int_t, Int_t, Int_t, Int_t> strawtubes::StrawDecode(Int_t detID)
         return std::make_tuple(statnb, vnb, lnb, snb);
     }
 }
+// -----   Private method StrawTableIndex    -------------------------------------------
+// -----   same decoding as StrawDecode, without warnings -----------------------------------
+Int_t strawtubes::StrawTableIndex(Int_t detID)
+{
+    Int_t statnb = detID / 1000000;
+    Int_t vnb = (detID % 1000000) / 100000;
+    Int_t lnb = (detID % 100000) / 10000;
+    Int_t snb = detID % 10000 - 2000;
+    if (statnb < 1 || statnb > kTableStations || vnb < 0 || vnb >= kTableViews || lnb < 0 || lnb >= kTableLayers
+        || snb < 1 || snb >= kTableStraws) {
+        return -1;
+    }
+    return (((statnb - 1) * kTableViews + vnb) * kTableLayers + lnb) * kTableStraws + snb;
+}
+// -----   Public method BuildStrawEndPointTable    -------------------------------------------
+// -----   walks station -> layer -> wire nodes once and stores the global end points -----------------------------------
+void strawtubes::BuildStrawEndPointTable()
+{
+    fStrawEndPoints.assign(6 * kTableSize, 0.);
+    fStrawEndPointsSet.assign(kTableSize, kFALSE);
+    fStrawEndPointsGeo = gGeoManager;
+    if (!gGeoManager) {
+        return;
+    }
+    TGeoNavigator* nav = gGeoManager->GetCurrentNavigator();
+    nav->CdTop();
+    TGeoNode* topNode = nav->GetCurrentNode();
+    Int_t nStraws = 0;
+    for (Int_t i = 0; i < topNode->GetNdaughters(); i++) {
+        // stations are the top level volumes Tr1 .. Tr4
+        TString stationName = topNode->GetDaughter(i)->GetVolume()->GetName();
+        if (stationName.Length() != 3 || !stationName.BeginsWith("Tr")) {
+            continue;
+        }
+        nav->CdDown(i);
+        TGeoNode* station = nav->GetCurrentNode();
+        for (Int_t j = 0; j < station->GetNdaughters(); j++) {
+            TString layerName = station->GetDaughter(j)->GetVolume()->GetName();
+            if (!layerName.Contains("_layer_")) {
+                continue;
+            }
+            nav->CdDown(j);
+            TGeoNode* layer = nav->GetCurrentNode();
+            for (Int_t k = 0; k < layer->GetNdaughters(); k++) {
+                TGeoNode* node = layer->GetDaughter(k);
+                if (strcmp(node->GetVolume()->GetName(), "wire") != 0) {
+                    continue;
+                }
+                // the wire copy number is the one of the (sensitive) gas volume + 1000
+                Int_t index = StrawTableIndex(node->GetNumber() - 1000);
+                if (index < 0) {
+                    continue;
+                }
+                nav->CdDown(k);
+                TGeoTube* S = dynamic_cast<TGeoTube*>(node->GetVolume()->GetShape());
+                Double_t top[3] = {0, 0, S->GetDZ()};
+                Double_t bot[3] = {0, 0, -S->GetDZ()};
+                nav->LocalToMaster(bot, &fStrawEndPoints[6 * index]);
+                nav->LocalToMaster(top, &fStrawEndPoints[6 * index + 3]);
+                fStrawEndPointsSet[index] = kTRUE;
+                nStraws++;
+                nav->CdUp();
+            }
+            nav->CdUp();
+        }
+        nav->CdUp();
+    }
+    LOG(info) << "strawtubes: end point table filled for " << nStraws << " straws";
+}
+// -----   Public method WriteStrawEndPointTable    -------------------------------------------
+Bool_t strawtubes::WriteStrawEndPointTable(const char* fileName)
+{
+    if (fStrawEndPointsGeo != gGeoManager || fStrawEndPoints.empty()) {
+        BuildStrawEndPointTable();
+    }
+    std::ofstream out(fileName);
+    if (!out.is_open()) {
+        LOG(error) << "strawtubes::WriteStrawEndPointTable, cannot open " << fileName;
+        return kFALSE;
+    }
+    out << "# detID xbot ybot zbot xtop ytop ztop" << std::endl;
+    out.precision(10);
+    for (Int_t index = 0; index < kTableSize; index++) {
+        if (!fStrawEndPointsSet[index]) {
+            continue;
+        }
+        Int_t snb = index % kTableStraws;
+        Int_t lnb = (index / kTableStraws) % kTableLayers;
+        Int_t vnb = (index / (kTableStraws * kTableLayers)) % kTableViews;
+        Int_t statnb = index / (kTableStraws * kTableLayers * kTableViews) + 1;
+        out << statnb * 1000000 + vnb * 100000 + lnb * 10000 + 2000 + snb;
+        for (Int_t c = 0; c < 6; c++) {
+            out << " " << fStrawEndPoints[6 * index + c];
+        }
+        out << std::endl;
+    }
+    return kTRUE;
+}
 // -----   Public method StrawEndPoints    -------------------------------------------
 // -----   returns top (left) and bottom (right) coordinates of straw -----------------------------------
 void strawtubes::StrawEndPoints(Int_t fDetectorID, TVector3 &vbot, TVector3 &vtop)
+// method to get end points from the table, filled once per (closed) geometry
+{
+    if (fStrawEndPointsGeo != gGeoManager || fStrawEndPoints.empty()) {
+        if (!gGeoManager || !gGeoManager->IsClosed()) {
+            StrawEndPointsNavigator(fDetectorID, vbot, vtop);
+            return;
+        }
+        BuildStrawEndPointTable();
+    }
+    Int_t index = StrawTableIndex(fDetectorID);
+    if (index < 0 || !fStrawEndPointsSet[index]) {
+        LOG(warning) << "strawtubes::StrawEndPoints, no straw with detID " << fDetectorID;
+        return;
+    }
+    const Double_t* p = &fStrawEndPoints[6 * index];
+    vbot.SetXYZ(p[0], p[1], p[2]);
+    vtop.SetXYZ(p[3], p[4], p[5]);
+}
+// -----   Private method StrawEndPointsNavigator    -------------------------------------------
+void strawtubes::StrawEndPointsNavigator(Int_t fDetectorID, TVector3 &vbot, TVector3 &vtop)
 // method to get end points from TGeoNavigator
 {
     const auto [statnb, vnb, lnb, snb] = StrawDecode(fDetectorID);
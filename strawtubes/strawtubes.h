@@ -6,9 +6,12 @@
 #include "TVector3.h"
 #include "TLorentzVector.h"
 
+#include <vector>
+
 class strawtubesPoint;
 class FairVolume;
 class TClonesArray;
+class TGeoManager;
 class tuple;
 
 class strawtubes: public FairDetector
@@ -65,6 +68,12 @@ class strawtubes: public FairDetector
     void set_station_height(Double_t station_height);
     static std::tuple<Int_t, Int_t, Int_t, Int_t> StrawDecode(Int_t detID);
     static void StrawEndPoints(Int_t detID, TVector3& top, TVector3& bot);
+    /**      Fill the straw end point table from the (closed) geometry, walking the
+     *       wire nodes once. StrawEndPoints() builds it on first use for each geometry
+    */
+    static void BuildStrawEndPointTable();
+    /**      Write the straw end point table as text: detID xbot ybot zbot xtop ytop ztop */
+    static Bool_t WriteStrawEndPointTable(const char* fileName);
     void StrawEndPointsOriginal(Int_t detID, TVector3 &top, TVector3 &bot);
 // for the digitizing step
     void SetStrawResolution(Double_t a, Double_t b)
@@ -147,6 +156,14 @@ class strawtubes: public FairDetector
     strawtubes(const strawtubes&);
     strawtubes& operator=(const strawtubes&);
     Int_t InitMedium(const char* name);
+    /** index of the straw in the end point table, or -1 for an invalid detID */
+    static Int_t StrawTableIndex(Int_t detID);
+    /** end points by navigating to the wire volume, used if no table can be built */
+    static void StrawEndPointsNavigator(Int_t detID, TVector3& vbot, TVector3& vtop);
+
+    static std::vector<Double_t> fStrawEndPoints;   //!  bot (x,y,z) and top (x,y,z) per straw
+    static std::vector<Bool_t> fStrawEndPointsSet;  //!  straws present in the geometry
+    static TGeoManager* fStrawEndPointsGeo;         //!  geometry used to fill the table
     ClassDef(strawtubes, 6)
 };
 
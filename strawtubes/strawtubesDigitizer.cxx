@@ -0,0 +1,181 @@
+#include "strawtubesDigitizer.h"
+
+#include "TClonesArray.h"
+#include "TH1.h"
+#include "TMath.h"
+#include "TRandom.h"
+#include "TVector3.h"
+#include "strawtubes.h"
+#include "strawtubesPoint.h"
+
+#include <math.h>
+
+namespace {
+const Double_t kSpeedOfLight = TMath::C() * 100. / 1000000000.0;   // from m/sec to cm/ns
+// straw of station 1 whose top z is the reference for the time of flight correction
+const Int_t kReferenceStraw = 1002001;
+// offset subtracted from the estimated t0 [ns]
+const Double_t kT0EstimateOffset = 73.2;
+}   // namespace
+
+// -----   Default constructor   -------------------------------------------
+strawtubesDigitizer::strawtubesDigitizer()
+    : strawtubesDigitizer(0., 0.)
+{}
+// -----   Standard constructor   ------------------------------------------
+strawtubesDigitizer::strawtubesDigitizer(Double_t vDrift, Double_t sigmaSpatial)
+    : fVdrift(vDrift)
+    , fSigmaSpatial(sigmaSpatial)
+    , fT0Estimate(0.)
+    , fDeadChannels()
+    , fEarliest()
+    , fDistY(nullptr)
+    , fDistU(nullptr)
+    , fDistV(nullptr)
+{}
+// -------------------------------------------------------------------------
+
+void strawtubesDigitizer::SetDeadChannels(const std::vector<Int_t>& detIDs)
+{
+    fDeadChannels.clear();
+    fDeadChannels.insert(detIDs.begin(), detIDs.end());
+}
+
+// -----   Public method Digitize   ----------------------------------------
+// -----   same smearing as strawtubesHit(strawtubesPoint*, t0) ------------
+void strawtubesDigitizer::Digitize(TClonesArray* points, Double_t t0, std::vector<strawtubesHit>& hits)
+{
+    TVector3 bot, top;
+    Int_t nPoints = points->GetEntriesFast();
+    Int_t offset = hits.size();
+    hits.reserve(offset + nPoints);
+    fEarliest.clear();
+    for (Int_t i = 0; i < nPoints; i++) {
+        strawtubesPoint* p = static_cast<strawtubesPoint*>(points->At(i));
+        Int_t detID = p->GetDetectorID();
+        strawtubes::StrawEndPoints(detID, bot, top);
+        Double_t t_drift = fabs(gRandom->Gaus(p->dist2Wire(), fSigmaSpatial)) / fVdrift;
+        hits.emplace_back(detID, t0 + p->GetTime() + t_drift + (top[0] - p->GetX()) / kSpeedOfLight);
+        strawtubesHit& hit = hits.back();
+        if (fDeadChannels.count(detID)) {
+            hit.setInvalid();
+            continue;
+        }
+        // the earliest hit per straw is valid, all later ones invalid
+        auto [it, inserted] = fEarliest.try_emplace(detID, offset + i);
+        if (inserted) {
+            continue;
+        }
+        strawtubesHit& earliest = hits[it->second];
+        if (earliest.GetTDC() > hit.GetTDC()) {
+            earliest.setInvalid();
+            it->second = offset + i;
+        } else {
+            hit.setInvalid();
+        }
+    }
+}
+
+void strawtubesDigitizer::ClearSmearedHits()
+{
+    fDigiHit.clear();
+    fDetID.clear();
+    fXtop.clear();
+    fYtop.clear();
+    fZ.clear();
+    fXbot.clear();
+    fYbot.clear();
+    fDist.clear();
+}
+
+void strawtubesDigitizer::AddSmearedHit(Int_t key, Int_t detID, const Double_t* bot, const Double_t* top, Double_t dist)
+{
+    fDigiHit.push_back(key);
+    fDetID.push_back(detID);
+    fXtop.push_back(top[0]);
+    fYtop.push_back(top[1]);
+    // top z == bot z unless misaligned, only the top one is kept
+    fZ.push_back(top[2]);
+    fXbot.push_back(bot[0]);
+    fYbot.push_back(bot[1]);
+    fDist.push_back(dist);
+}
+
+// -----   Public method SmearHits   ---------------------------------------
+void strawtubesDigitizer::SmearHits(TClonesArray* points,
+                                    const std::vector<strawtubesHit>& hits,
+                                    Double_t t0,
+                                    Bool_t noSmearing)
+{
+    ClearSmearedHits();
+    TVector3 bot, top;
+    Int_t nHits = hits.size();
+    for (Int_t key = 0; key < nHits; key++) {
+        const strawtubesHit& hit = hits[key];
+        if (!hit.isValid()) {
+            continue;
+        }
+        Int_t detID = hit.GetDetectorID();
+        strawtubes::StrawEndPoints(detID, bot, top);
+        strawtubesPoint* p = static_cast<strawtubesPoint*>(points->At(key));
+        Double_t smear = (hit.GetDigi() - t0 - p->GetTime() - (top[0] - p->GetX()) / kSpeedOfLight) * fVdrift;
+        if (noSmearing) {
+            smear = p->dist2Wire();
+        }
+        Double_t b[3] = {bot.X(), bot.Y(), bot.Z()};
+        Double_t t[3] = {top.X(), top.Y(), top.Z()};
+        AddSmearedHit(key, detID, b, t, smear);
+        Double_t atop = fabs(top.Y());
+        Double_t abot = fabs(bot.Y());
+        TH1* h = atop == abot ? fDistY : (atop > abot ? fDistU : fDistV);
+        if (h) {
+            h->Fill(smear);
+        }
+    }
+}
+
+// -----   Public method SmearHitsWithT0Estimate   -------------------------
+void strawtubesDigitizer::SmearHitsWithT0Estimate(const std::vector<strawtubesHit>& hits)
+{
+    ClearSmearedHits();
+    TVector3 bot, top;
+    strawtubes::StrawEndPoints(kReferenceStraw, bot, top);
+    Double_t z1 = top.Z();
+    Double_t t0 = 0.;
+    Int_t nHits = hits.size();
+    for (Int_t key = 0; key < nHits; key++) {
+        const strawtubesHit& hit = hits[key];
+        if (!hit.isValid()) {
+            continue;
+        }
+        Int_t detID = hit.GetDetectorID();
+        strawtubes::StrawEndPoints(detID, bot, top);
+        t0 += hit.GetDigi() - (bot.Z() - z1) / kSpeedOfLight;
+        Double_t b[3] = {bot.X(), bot.Y(), bot.Z()};
+        Double_t t[3] = {top.X(), top.Y(), top.Z()};
+        AddSmearedHit(key, detID, b, t, hit.GetDigi());
+    }
+    Int_t n = fDigiHit.size();
+    if (n > 0) {
+        t0 = t0 / n - kT0EstimateOffset;
+    }
+    fT0Estimate = t0;
+    for (Int_t i = 0; i < n; i++) {
+        fDist[i] = (fDist[i] - (fZ[i] - z1) / kSpeedOfLight - t0) * fVdrift;
+    }
+}
+
+// -----   Public method Exec   --------------------------------------------
+void strawtubesDigitizer::Exec(TClonesArray* points,
+                               Double_t t0,
+                               std::vector<strawtubesHit>& hits,
+                               Bool_t withT0,
+                               Bool_t noSmearing)
+{
+    Digitize(points, t0, hits);
+    if (withT0) {
+        SmearHitsWithT0Estimate(hits);
+    } else {
+        SmearHits(points, hits, t0, noSmearing);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef STRAWTUBES_STRAWTUBESDIGITIZER_H_
+#define STRAWTUBES_STRAWTUBESDIGITIZER_H_ 1
+
+#include "Rtypes.h"
+#include "strawtubesHit.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class TClonesArray;
+class TH1;
+
+/**
+ ** Digitisation of all strawtubesPoints of an event in one call:
+ ** drift time smearing, dead channel masking and the earliest hit per straw rule,
+ ** followed by the smeared hits for the pattern recognition, either with the true
+ ** t0 or with the t0 estimated from the hits themselves.
+ **
+ ** The smeared hits are kept as parallel vectors, entry i describes the valid hit
+ ** with index GetDigiHit()[i] in the hit vector.
+ **/
+class strawtubesDigitizer
+{
+  public:
+    /** Constructor with arguments
+     *@param vDrift        drift velocity [cm/ns]
+     *@param sigmaSpatial  spatial resolution [cm]
+     **/
+    strawtubesDigitizer(Double_t vDrift, Double_t sigmaSpatial);
+    strawtubesDigitizer();
+    virtual ~strawtubesDigitizer() = default;
+
+    void SetResolution(Double_t vDrift, Double_t sigmaSpatial)
+    {
+        fVdrift = vDrift;
+        fSigmaSpatial = sigmaSpatial;
+    }
+    /** hits in these straws are marked invalid **/
+    void SetDeadChannels(const std::vector<Int_t>& detIDs);
+    void AddDeadChannel(Int_t detID) { fDeadChannels.insert(detID); }
+    /** optional distance histograms filled by SmearHits, for y, u and v views **/
+    void SetDistHistograms(TH1* disty, TH1* distu, TH1* distv)
+    {
+        fDistY = disty;
+        fDistU = distu;
+        fDistV = distv;
+    }
+
+    /** Append one hit per point to hits, the earliest hit of each live straw is valid **/
+    void Digitize(TClonesArray* points, Double_t t0, std::vector<strawtubesHit>& hits);
+
+    /** Smeared hits using the true t0 and point time, or the true distance to the wire if noSmearing **/
+    void SmearHits(TClonesArray* points, const std::vector<strawtubesHit>& hits, Double_t t0, Bool_t noSmearing = kFALSE);
+
+    /** Smeared hits using the t0 estimated from the mean of the hit times corrected for time of flight **/
+    void SmearHitsWithT0Estimate(const std::vector<strawtubesHit>& hits);
+
+    /** Digitize followed by SmearHitsWithT0Estimate (withT0) or SmearHits **/
+    void Exec(TClonesArray* points,
+              Double_t t0,
+              std::vector<strawtubesHit>& hits,
+              Bool_t withT0 = kFALSE,
+              Bool_t noSmearing = kFALSE);
+
+    /** Smeared hits of the last SmearHits call **/
+    Int_t GetNSmearedHits() const { return fDigiHit.size(); }
+    const std::vector<Int_t>& GetDigiHit() const { return fDigiHit; }
+    const std::vector<Int_t>& GetDetID() const { return fDetID; }
+    const std::vector<Double_t>& GetXtop() const { return fXtop; }
+    const std::vector<Double_t>& GetYtop() const { return fYtop; }
+    const std::vector<Double_t>& GetZ() const { return fZ; }
+    const std::vector<Double_t>& GetXbot() const { return fXbot; }
+    const std::vector<Double_t>& GetYbot() const { return fYbot; }
+    const std::vector<Double_t>& GetDist() const { return fDist; }
+    /** t0 of the last SmearHitsWithT0Estimate call **/
+    Double_t GetT0Estimate() const { return fT0Estimate; }
+
+  private:
+    void ClearSmearedHits();
+    void AddSmearedHit(Int_t key, Int_t detID, const Double_t* bot, const Double_t* top, Double_t dist);
+
+    Double_t fVdrift;         ///< drift velocity
+    Double_t fSigmaSpatial;   ///< spatial resolution
+    Double_t fT0Estimate;     ///< t0 from SmearHitsWithT0Estimate
+    std::unordered_set<Int_t> fDeadChannels;
+    std::unordered_map<Int_t, Int_t> fEarliest;   ///< detID -> index of the valid hit, per event
+    TH1* fDistY;
+    TH1* fDistU;
+    TH1* fDistV;
+
+    std::vector<Int_t> fDigiHit;
+    std::vector<Int_t> fDetID;
+    std::vector<Double_t> fXtop;
+    std::vector<Double_t> fYtop;
+    std::vector<Double_t> fZ;
+    std::vector<Double_t> fXbot;
+    std::vector<Double_t> fYbot;
+    std::vector<Double_t> fDist;
+};
+
+#endif   // STRAWTUBES_STRAWTUBESDIGITIZER_H_
@@ -8,6 +8,8 @@
 #pragma link C++ class strawtubes+;
 #pragma link C++ class strawtubesPoint+;
 #pragma link C++ class strawtubesHit+;
+#pragma link C++ class strawtubesDigitizer;
+#pragma link C++ class strawtubesPatRec;
 #pragma link C++ class Tracklet+;
 
 #endif
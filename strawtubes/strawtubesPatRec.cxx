@@ -0,0 +1,325 @@
+#include "strawtubesPatRec.h"
+
+#include "TMath.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+/** station and view of the detector ID as strawtubes::StrawDecode, station 0 if invalid **/
+void DecodeView(Int_t detID, Int_t& station, Int_t& view)
+{
+    station = detID / 1000000;
+    view = (detID % 1000000) / 100000;
+    Int_t layer = (detID % 100000) / 10000;
+    Int_t straw = detID % 10000 - 2000;
+    if (station < 1 || station > 4 || view < 0 || view > 3 || layer < 0 || layer > 1 || straw < 1 || straw > 299) {
+        station = 0;
+        view = -1;
+    }
+}
+
+/** indices sorting values in decreasing order, equal values in decreasing index (reversed stable argsort) **/
+std::vector<Int_t> ReversedArgsort(const std::vector<Double_t>& values)
+{
+    std::vector<Int_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&values](Int_t a, Int_t b) { return values[a] < values[b]; });
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+}   // namespace
+
+// -----   Default constructor   -------------------------------------------
+strawtubesPatRec::strawtubesPatRec()
+    : fMethod(kTemplateMatching)
+    , fMinHits(3)
+    , fMaxX(200.)
+{}
+
+void strawtubesPatRec::ClearHits()
+{
+    fDigiHit.clear();
+    fDetID.clear();
+    fXtop.clear();
+    fYtop.clear();
+    fZ.clear();
+    fXbot.clear();
+    fYbot.clear();
+}
+
+void strawtubesPatRec::AddHit(Int_t digiHit,
+                              Int_t detID,
+                              Double_t xtop,
+                              Double_t ytop,
+                              Double_t z,
+                              Double_t xbot,
+                              Double_t ybot)
+{
+    fDigiHit.push_back(digiHit);
+    fDetID.push_back(detID);
+    fXtop.push_back(xtop);
+    fYtop.push_back(ytop);
+    fZ.push_back(z);
+    fXbot.push_back(xbot);
+    fYbot.push_back(ybot);
+}
+
+// -----   Public method Execute   -----------------------------------------
+Int_t strawtubesPatRec::Execute(Int_t method, Double_t zMagnet)
+{
+    fMethod = method;
+    fTracks.clear();
+
+    std::vector<Int_t> y12, stereo12, y34, stereo34;
+    Int_t station, view;
+    for (Int_t i = 0; i < GetNHits(); i++) {
+        DecodeView(fDetID[i], station, view);
+        Bool_t yView = view == 0 || view == 3;
+        Bool_t stereoView = view == 1 || view == 2;
+        if (station == 1 || station == 2) {
+            if (yView) {
+                y12.push_back(i);
+            } else if (stereoView) {
+                stereo12.push_back(i);
+            }
+        } else if (station == 3 || station == 4) {
+            if (yView) {
+                y34.push_back(i);
+            } else if (stereoView) {
+                stereo34.push_back(i);
+            }
+        }
+    }
+
+    fUsed.assign(GetNHits(), 0);
+    fProj.assign(GetNHits(), 0.);
+    std::vector<Candidate> tracks12, tracks34;
+    PatRecY(y12, tracks12);
+    PatRecStereo(stereo12, tracks12);
+    PatRecY(y34, tracks34);
+    PatRecStereo(stereo34, tracks34);
+    Combine(tracks12, tracks34, zMagnet);
+    return fTracks.size();
+}
+
+Bool_t strawtubesPatRec::InWindow(Double_t x, Double_t y, Double_t k, Double_t b, Bool_t stereo) const
+{
+    if (fMethod == kTemplateMatching) {
+        // hit_in_window
+        Double_t width = stereo ? 15. : 1.4;
+        return TMath::Abs(k * x + b - y) <= width;
+    }
+    // hit_in_bin
+    Double_t kSize = stereo ? 0.6 / 200 : 0.7 / 2000;
+    Double_t bSize = stereo ? 1000. / 70 : 1700. / 1000;
+    Double_t bLeft = y - (k - 0.5 * kSize) * x;
+    Double_t bRight = y - (k + 0.5 * kSize) * x;
+    return (bLeft >= b - 0.5 * bSize && bRight <= b + 0.5 * bSize)
+           || (bLeft <= b + 0.5 * bSize && bRight >= b - 0.5 * bSize);
+}
+
+void strawtubesPatRec::FitLine(const std::vector<Double_t>& x, const std::vector<Double_t>& y, Double_t& k, Double_t& b)
+{
+    // least squares line, as np.polyfit(x, y, deg=1)
+    Int_t n = x.size();
+    Double_t xm = 0, ym = 0;
+    for (Int_t i = 0; i < n; i++) {
+        xm += x[i];
+        ym += y[i];
+    }
+    xm /= n;
+    ym /= n;
+    Double_t sxx = 0, sxy = 0;
+    for (Int_t i = 0; i < n; i++) {
+        sxx += (x[i] - xm) * (x[i] - xm);
+        sxy += (x[i] - xm) * (y[i] - ym);
+    }
+    k = sxx > 0 ? sxy / sxx : 0.;
+    b = ym - k * xm;
+}
+
+void strawtubesPatRec::PatRecY(const std::vector<Int_t>& hits, std::vector<Candidate>& tracks) const
+{
+    tracks.clear();
+    std::vector<Candidate> candidates;
+    std::vector<Int_t> layers;
+    for (Int_t h1 : hits) {
+        for (Int_t h2 : hits) {
+            if (fZ[h1] >= fZ[h2] || fDetID[h1] == fDetID[h2]) {
+                continue;
+            }
+            Double_t k = 1. * (fYtop[h2] - fYtop[h1]) / (fZ[h2] - fZ[h1]);
+            Double_t b = fYtop[h1] - k * fZ[h1];
+            if (TMath::Abs(k) > 1) {
+                continue;
+            }
+            Candidate c;
+            c.hits = {h1, h2};
+            layers = {fDetID[h1] / 10000, fDetID[h2] / 10000};
+            for (Int_t h3 : hits) {
+                if (fDetID[h3] == fDetID[h1] || fDetID[h3] == fDetID[h2]) {
+                    continue;
+                }
+                Int_t layer3 = fDetID[h3] / 10000;
+                if (std::find(layers.begin(), layers.end(), layer3) != layers.end()) {
+                    continue;
+                }
+                if (InWindow(fZ[h3], fYtop[h3], k, b, kFALSE)) {
+                    c.hits.push_back(h3);
+                    layers.push_back(layer3);
+                }
+            }
+            if ((Int_t)c.hits.size() >= fMinHits) {
+                candidates.push_back(std::move(c));
+            }
+        }
+    }
+
+    ReduceClones(candidates);
+
+    std::vector<Double_t> z, y;
+    for (auto& c : candidates) {
+        z.clear();
+        y.clear();
+        for (Int_t h : c.hits) {
+            z.push_back(fZ[h]);
+            y.push_back(fYtop[h]);
+        }
+        FitLine(z, y, c.k, c.b);
+    }
+    tracks = std::move(candidates);
+}
+
+void strawtubesPatRec::ReduceClones(std::vector<Candidate>& tracks) const
+{
+    std::vector<Double_t> nHits;
+    for (const auto& c : tracks) {
+        nHits.push_back(c.hits.size());
+    }
+    std::vector<Char_t> used(GetNHits(), 0);
+    std::vector<Candidate> reduced;
+    for (Int_t i : ReversedArgsort(nHits)) {
+        Candidate c;
+        for (Int_t h : tracks[i].hits) {
+            if (!used[h]) {
+                c.hits.push_back(h);
+            }
+        }
+        if ((Int_t)c.hits.size() >= fMinHits) {
+            for (Int_t h : c.hits) {
+                used[h] = 1;
+            }
+            reduced.push_back(std::move(c));
+        }
+    }
+    tracks = std::move(reduced);
+}
+
+void strawtubesPatRec::PatRecStereo(const std::vector<Int_t>& hits, std::vector<Candidate>& tracks)
+{
+    std::vector<Int_t> best, candidate, layers;
+    for (auto& track : tracks) {
+        // projection of the stereo wires at the z of the hit with the y track (get_zy_projection)
+        for (Int_t h : hits) {
+            Double_t x = track.k * fZ[h] + track.b;
+            Double_t k = (fXtop[h] - fXbot[h]) / (fYtop[h] - fYbot[h] + 1e-6);
+            Double_t b = fXtop[h] - k * fYtop[h];
+            fProj[h] = k * x + b;
+        }
+
+        best.clear();
+        for (Int_t h1 : hits) {
+            for (Int_t h2 : hits) {
+                if (fZ[h1] >= fZ[h2] || fDetID[h1] == fDetID[h2] || fUsed[h1] || fUsed[h2]) {
+                    continue;
+                }
+                if (TMath::Abs(fProj[h1]) > fMaxX || TMath::Abs(fProj[h2]) > fMaxX) {
+                    continue;
+                }
+                Double_t k = 1. * (fProj[h2] - fProj[h1]) / (fZ[h2] - fZ[h1]);
+                Double_t b = fProj[h1] - k * fZ[h1];
+                candidate = {h1, h2};
+                layers = {fDetID[h1] / 10000, fDetID[h2] / 10000};
+                for (Int_t h3 : hits) {
+                    if (h3 == h1 || h3 == h2 || fUsed[h3] || TMath::Abs(fProj[h3]) > fMaxX) {
+                        continue;
+                    }
+                    Int_t layer3 = fDetID[h3] / 10000;
+                    if (std::find(layers.begin(), layers.end(), layer3) != layers.end()) {
+                        continue;
+                    }
+                    if (InWindow(fZ[h3], fProj[h3], k, b, kTRUE)) {
+                        candidate.push_back(h3);
+                        layers.push_back(layer3);
+                    }
+                }
+                // the first of the longest candidates
+                if ((Int_t)candidate.size() >= fMinHits && candidate.size() > best.size()) {
+                    best.swap(candidate);
+                }
+            }
+        }
+        track.stereo = best;
+        for (Int_t h : best) {
+            fUsed[h] = 1;
+        }
+    }
+}
+
+void strawtubesPatRec::Combine(const std::vector<Candidate>& tracks12,
+                               const std::vector<Candidate>& tracks34,
+                               Double_t zMagnet)
+{
+    const Double_t maxDy = 50;
+    std::vector<Int_t> i12, i34;
+    std::vector<Double_t> dy;
+    for (size_t i = 0; i < tracks12.size(); i++) {
+        Double_t y12 = tracks12[i].k * zMagnet + tracks12[i].b;
+        for (size_t j = 0; j < tracks34.size(); j++) {
+            Double_t y34 = tracks34[j].k * zMagnet + tracks34[j].b;
+            i12.push_back(i);
+            i34.push_back(j);
+            dy.push_back(TMath::Abs(y12 - y34));
+        }
+    }
+
+    // increasing dy, equal dy in increasing index
+    std::vector<Int_t> order(dy.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&dy](Int_t a, Int_t b) { return dy[a] < dy[b]; });
+
+    std::vector<std::array<const std::vector<Int_t>*, 4>> combined;
+    std::vector<Char_t> used12(tracks12.size(), 0), used34(tracks34.size(), 0);
+    const std::vector<Int_t> none;
+    for (Int_t n : order) {
+        if (dy[n] < maxDy && !used12[i12[n]] && !used34[i34[n]]) {
+            const Candidate& t12 = tracks12[i12[n]];
+            const Candidate& t34 = tracks34[i34[n]];
+            combined.push_back({&t12.hits, &t12.stereo, &t34.hits, &t34.stereo});
+            used12[i12[n]] = 1;
+            used34[i34[n]] = 1;
+        }
+    }
+    for (size_t i = 0; i < tracks12.size(); i++) {
+        if (!used12[i]) {
+            combined.push_back({&tracks12[i].hits, &tracks12[i].stereo, &none, &none});
+        }
+    }
+    for (size_t j = 0; j < tracks34.size(); j++) {
+        if (!used34[j]) {
+            combined.push_back({&none, &none, &tracks34[j].hits, &tracks34[j].stereo});
+        }
+    }
+
+    // tracks with enough hits in all views
+    for (const auto& c : combined) {
+        Bool_t good = kTRUE;
+        for (Int_t v = 0; v < 4; v++) {
+            good = good && (Int_t)c[v]->size() >= fMinHits;
+        }
+        if (good) {
+            fTracks.push_back({*c[kY12], *c[kStereo12], *c[kY34], *c[kStereo34]});
+        }
+    }
+}
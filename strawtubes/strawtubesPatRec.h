@@ -0,0 +1,97 @@
+#ifndef STRAWTUBES_STRAWTUBESPATREC_H_
+#define STRAWTUBES_STRAWTUBESPATREC_H_ 1
+
+#include "Rtypes.h"
+
+#include <array>
+#include <vector>
+
+/**
+ ** Straw tracker pattern recognition of shipPatRec.py ("TemplateMatching" and "FH")
+ ** on flat hit arrays:
+ **  - hits are split into the y and stereo views before (12) and after (34) the magnet
+ **  - y views: every pair of hits is a seed, hits of other layers inside the window
+ **    (template matching) or the (k, b) bin (fast Hough) of the seed are added,
+ **    clones are removed keeping one track per hit, tracks are fitted with a line
+ **  - stereo views: the same search on the stereo hits projected with the y track,
+ **    the longest candidate is kept and its hits are not used for later y tracks
+ **  - tracks before and after the magnet are combined by their y at the magnet centre
+ ** Tracks are returned as indices into the hit arrays, one list per view.
+ **/
+class strawtubesPatRec
+{
+  public:
+    enum Method
+    {
+        kTemplateMatching = 0,
+        kFastHough = 1
+    };
+    enum View
+    {
+        kY12 = 0,
+        kStereo12 = 1,
+        kY34 = 2,
+        kStereo34 = 3
+    };
+
+    strawtubesPatRec();
+    virtual ~strawtubesPatRec() = default;
+
+    /** stereo hits projected further than this from the centre are ignored [cm] **/
+    void SetStrawLength(Double_t length) { fMaxX = length; }
+    void SetMinHits(Int_t minHits) { fMinHits = minHits; }
+
+    void ClearHits();
+    /** hit with the smeared wire end points, digiHit is the key of the hit **/
+    void AddHit(Int_t digiHit, Int_t detID, Double_t xtop, Double_t ytop, Double_t z, Double_t xbot, Double_t ybot);
+    Int_t GetNHits() const { return fDetID.size(); }
+
+    /** Pattern recognition of the hits, zMagnet is the z of the magnet centre, returns the number of tracks **/
+    Int_t Execute(Int_t method, Double_t zMagnet);
+
+    Int_t GetNTracks() const { return fTracks.size(); }
+    /** hits of the track in the view, as indices of AddHit calls **/
+    const std::vector<Int_t>& GetTrackHits(Int_t track, Int_t view) const { return fTracks[track][view]; }
+
+  private:
+    struct Candidate
+    {
+        std::vector<Int_t> hits;
+        std::vector<Int_t> stereo;
+        Double_t k;
+        Double_t b;
+    };
+
+    /** y view of the hits, recognised tracks with hits, k and b **/
+    void PatRecY(const std::vector<Int_t>& hits, std::vector<Candidate>& tracks) const;
+    /** stereo hits of the y tracks **/
+    void PatRecStereo(const std::vector<Int_t>& hits, std::vector<Candidate>& tracks);
+    /** one track per hit, longest tracks first **/
+    void ReduceClones(std::vector<Candidate>& tracks) const;
+    /** pairs (12, 34) of tracks with the closest y at the magnet, then the single ones **/
+    void Combine(const std::vector<Candidate>& tracks12, const std::vector<Candidate>& tracks34, Double_t zMagnet);
+    /** hit (x, y) compatible with the line y = k x + b **/
+    Bool_t InWindow(Double_t x, Double_t y, Double_t k, Double_t b, Bool_t stereo) const;
+    static void FitLine(const std::vector<Double_t>& x, const std::vector<Double_t>& y, Double_t& k, Double_t& b);
+
+    Int_t fMethod;
+    Int_t fMinHits;
+    Double_t fMaxX;
+
+    // hits
+    std::vector<Int_t> fDigiHit;
+    std::vector<Int_t> fDetID;
+    std::vector<Double_t> fXtop;
+    std::vector<Double_t> fYtop;
+    std::vector<Double_t> fZ;
+    std::vector<Double_t> fXbot;
+    std::vector<Double_t> fYbot;
+
+    // per event work space
+    std::vector<Double_t> fProj;     ///< stereo hit projection for the current y track
+    std::vector<Char_t> fUsed;       ///< stereo hit taken by a previous y track
+
+    std::vector<std::array<std::vector<Int_t>, 4>> fTracks;
+};
+
+#endif   // STRAWTUBES_STRAWTUBESPATREC_H_